@@ -0,0 +1,383 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * instrument - Opt-in hot-path statistics for easyfind, Span and MutantStack
+ *
+ * Build with `make INSTRUMENT=1` (which defines CPP08_INSTRUMENT) and the
+ * CPP08_TIME / CPP08_RECORD hooks in the three exercises start recording;
+ * without it they expand to nothing and the instrumented code compiles
+ * exactly as before.
+ *
+ * Each probe keeps a count, a sum, a maximum and an HDR-style histogram:
+ * power-of-two ranges split into 8 linear buckets, so any recorded value
+ * is known to within 12.5%. Timed probes record nanoseconds; scan lengths
+ * record element counts.
+ *
+ * Recording never takes a lock: every thread writes its own block of
+ * counters (plain loads and stores on relaxed atomics, no read-modify-
+ * write). The blocks are registered once per thread; a thread that exits
+ * folds its block into a shared total and hands it to the next thread.
+ * snapshot(), toJson(), toPrometheus() and dump() read every block on
+ * demand, while other threads keep recording.
+ */
+namespace instrument {
+
+enum Probe {
+    SPAN_ADD_NUMBER,        // ns per Span::addNumber
+    SPAN_SHORTEST_SPAN,     // ns per Span::shortestSpan
+    SPAN_LONGEST_SPAN,      // ns per Span::longestSpan
+    STACK_PUSH,             // ns per MutantStack push/emplace
+    STACK_POP,              // ns per MutantStack pop
+    STACK_ITERATE,          // Stack size each time iteration starts
+    EASYFIND_HIT,           // ns per easyfind that found the value
+    EASYFIND_MISS,          // ns per easyfind that did not
+    EASYFIND_SCAN,          // Elements compared per linear easyfind
+    PROBE_COUNT
+};
+
+inline const char* probeName(Probe probe) {
+    static const char* const names[PROBE_COUNT] = {
+        "span_add_number", "span_shortest_span", "span_longest_span",
+        "stack_push", "stack_pop", "stack_iterate",
+        "easyfind_hit", "easyfind_miss", "easyfind_scan"
+    };
+    return names[probe];
+}
+
+inline const char* probeUnit(Probe probe) {
+    return probe == STACK_ITERATE || probe == EASYFIND_SCAN ? "elements" : "ns";
+}
+
+// Histogram layout: values below 8 get a bucket each, then every
+// power-of-two range [2^k, 2^(k+1)) is split into 8 equal buckets
+const unsigned int SUB_BUCKET_BITS = 3;
+const unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+const unsigned int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+inline unsigned int bucketOf(std::uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<unsigned int>(value);
+    }
+    unsigned int shift = static_cast<unsigned int>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<unsigned int>((value >> shift) - SUB_BUCKETS);
+}
+
+// Smallest value that lands in bucket
+inline std::uint64_t bucketFloor(unsigned int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    unsigned int shift = bucket / SUB_BUCKETS - 1;
+    return static_cast<std::uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+}
+
+/**
+ * ProbeStats - Merged statistics of one probe over all threads
+ */
+struct ProbeStats {
+    std::uint64_t count;
+    std::uint64_t sum;
+    std::uint64_t max;
+    std::vector<std::uint64_t> buckets;
+
+    ProbeStats() : count(0), sum(0), max(0), buckets(BUCKETS, 0) {}
+
+    double mean() const {
+        return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+    }
+
+    /**
+     * Value at quantile q, to within the bucket width (12.5%)
+     * @param q Between 0 and 1, e.g. 0.99
+     * @return The floor of the bucket holding that quantile, 0 if empty
+     */
+    std::uint64_t percentile(double q) const {
+        if (count == 0) {
+            return 0;
+        }
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (unsigned int b = 0; b < BUCKETS; ++b) {
+            seen += buckets[b];
+            if (seen >= rank) {
+                return bucketFloor(b);
+            }
+        }
+        return max;
+    }
+};
+
+typedef std::vector<ProbeStats> Snapshot;
+
+namespace detail {
+
+// One thread's counters; only the owning thread writes them
+struct Block {
+    struct Counters {
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> sum;
+        std::atomic<std::uint64_t> max;
+        std::atomic<std::uint64_t> buckets[BUCKETS];
+    };
+    Counters probes[PROBE_COUNT];
+
+    Block() {
+        clear();
+    }
+
+    void clear() {
+        for (unsigned int p = 0; p < PROBE_COUNT; ++p) {
+            probes[p].count.store(0, std::memory_order_relaxed);
+            probes[p].sum.store(0, std::memory_order_relaxed);
+            probes[p].max.store(0, std::memory_order_relaxed);
+            for (unsigned int b = 0; b < BUCKETS; ++b) {
+                probes[p].buckets[b].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void addTo(Snapshot& totals) const {
+        for (unsigned int p = 0; p < PROBE_COUNT; ++p) {
+            ProbeStats& stats = totals[p];
+            stats.count += probes[p].count.load(std::memory_order_relaxed);
+            stats.sum += probes[p].sum.load(std::memory_order_relaxed);
+            std::uint64_t max = probes[p].max.load(std::memory_order_relaxed);
+            if (max > stats.max) {
+                stats.max = max;
+            }
+            for (unsigned int b = 0; b < BUCKETS; ++b) {
+                stats.buckets[b] += probes[p].buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Single owner increment: no lock prefix, readers may see it late
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t by) {
+    counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+// Every thread's block, plus the totals of threads that have exited
+class Registry {
+private:
+    std::mutex _mutex;
+    std::vector<Block*> _live;
+    std::vector<Block*> _spare;
+    Snapshot _exited;
+
+public:
+    Registry() : _exited(PROBE_COUNT) {}
+
+    Block* acquire() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Block* block;
+        if (_spare.empty()) {
+            block = new Block();
+        } else {
+            block = _spare.back();
+            _spare.pop_back();
+        }
+        _live.push_back(block);
+        return block;
+    }
+
+    void release(Block* block) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        block->addTo(_exited);
+        block->clear();
+        for (std::size_t i = 0; i < _live.size(); ++i) {
+            if (_live[i] == block) {
+                _live[i] = _live.back();
+                _live.pop_back();
+                break;
+            }
+        }
+        _spare.push_back(block);
+    }
+
+    Snapshot collect() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Snapshot totals(_exited);
+        for (std::size_t i = 0; i < _live.size(); ++i) {
+            _live[i]->addTo(totals);
+        }
+        return totals;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _exited.assign(PROBE_COUNT, ProbeStats());
+        for (std::size_t i = 0; i < _live.size(); ++i) {
+            _live[i]->clear();
+        }
+    }
+};
+
+// Never destroyed, so threads exiting during static destruction can
+// still hand back their blocks
+inline Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+struct ThreadSlot {
+    Block* block;
+
+    ThreadSlot() : block(registry().acquire()) {}
+
+    ~ThreadSlot() {
+        registry().release(block);
+    }
+};
+
+inline Block& threadBlock() {
+    static thread_local ThreadSlot slot;
+    return *slot.block;
+}
+
+} // namespace detail
+
+/**
+ * Record one event
+ * @param probe Which probe
+ * @param value Nanoseconds or an element count, see Probe
+ */
+inline void record(Probe probe, std::uint64_t value) {
+    detail::Block::Counters& counters = detail::threadBlock().probes[probe];
+    detail::bump(counters.count, 1);
+    detail::bump(counters.sum, value);
+    if (value > counters.max.load(std::memory_order_relaxed)) {
+        counters.max.store(value, std::memory_order_relaxed);
+    }
+    detail::bump(counters.buckets[bucketOf(value)], 1);
+}
+
+/**
+ * ScopedTimer - Records the nanoseconds between construction and
+ * destruction, including when the scope is left by an exception
+ */
+class ScopedTimer {
+private:
+    Probe _probe;
+    std::chrono::steady_clock::time_point _start;
+
+    // Timers measure one scope and cannot be copied
+    ScopedTimer(const ScopedTimer& other);
+    ScopedTimer& operator=(const ScopedTimer& other);
+
+public:
+    explicit ScopedTimer(Probe probe) : _probe(probe), _start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - _start;
+        record(_probe, static_cast<std::uint64_t>(elapsed.count()));
+    }
+};
+
+// All probes merged over every thread, live and exited
+inline Snapshot snapshot() {
+    return detail::registry().collect();
+}
+
+// Forget everything recorded so far (events recorded concurrently by
+// other threads may survive or be lost)
+inline void reset() {
+    detail::registry().clear();
+}
+
+/**
+ * Statistics as JSON: one object per probe with count, sum, mean, max,
+ * p50/p90/p99 and the non-empty histogram buckets as [floor, count] pairs
+ */
+inline std::string toJson(const Snapshot& stats) {
+    std::ostringstream out;
+    out << "{\n  \"probes\": {";
+    for (unsigned int p = 0; p < PROBE_COUNT; ++p) {
+        const ProbeStats& probe = stats[p];
+        out << (p == 0 ? "\n" : ",\n") << "    \"" << probeName(static_cast<Probe>(p)) << "\": {"
+            << "\"unit\": \"" << probeUnit(static_cast<Probe>(p)) << "\", "
+            << "\"count\": " << probe.count << ", \"sum\": " << probe.sum
+            << ", \"mean\": " << probe.mean() << ", \"max\": " << probe.max
+            << ", \"p50\": " << probe.percentile(0.50) << ", \"p90\": " << probe.percentile(0.90)
+            << ", \"p99\": " << probe.percentile(0.99) << ", \"buckets\": [";
+        bool first = true;
+        for (unsigned int b = 0; b < BUCKETS; ++b) {
+            if (probe.buckets[b] != 0) {
+                out << (first ? "" : ", ") << "[" << bucketFloor(b) << ", " << probe.buckets[b] << "]";
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << "\n  }\n}\n";
+    return out.str();
+}
+
+/**
+ * Statistics in the Prometheus text format: a cumulative histogram per
+ * probe, named cpp08_<probe>_<unit>, with le bounds at the bucket edges
+ */
+inline std::string toPrometheus(const Snapshot& stats) {
+    std::ostringstream out;
+    for (unsigned int p = 0; p < PROBE_COUNT; ++p) {
+        const ProbeStats& probe = stats[p];
+        std::string name = std::string("cpp08_") + probeName(static_cast<Probe>(p)) + "_"
+                           + (probeUnit(static_cast<Probe>(p))[0] == 'n' ? "nanoseconds" : "elements");
+        out << "# TYPE " << name << " histogram\n";
+        std::uint64_t cumulative = 0;
+        for (unsigned int b = 0; b < BUCKETS; ++b) {
+            if (probe.buckets[b] != 0) {
+                cumulative += probe.buckets[b];
+                // Bucket b holds values up to the next bucket's floor
+                out << name << "_bucket{le=\"" << bucketFloor(b + 1) - 1 << "\"} " << cumulative << "\n";
+            }
+        }
+        out << name << "_bucket{le=\"+Inf\"} " << probe.count << "\n"
+            << name << "_sum " << probe.sum << "\n"
+            << name << "_count " << probe.count << "\n";
+    }
+    return out.str();
+}
+
+enum Format {
+    JSON,
+    PROMETHEUS
+};
+
+/**
+ * Write the current statistics to a file
+ * @param path Destination, overwritten
+ * @param format JSON or PROMETHEUS
+ * @return false if the file could not be written
+ */
+inline bool dump(const std::string& path, Format format = JSON) {
+    Snapshot stats = snapshot();
+    std::ofstream file(path.c_str());
+    file << (format == JSON ? toJson(stats) : toPrometheus(stats));
+    return static_cast<bool>(file);
+}
+
+} // namespace instrument
+
+#ifdef CPP08_INSTRUMENT
+# define CPP08_INSTRUMENT_CONCAT2(a, b) a##b
+# define CPP08_INSTRUMENT_CONCAT(a, b) CPP08_INSTRUMENT_CONCAT2(a, b)
+// Time the rest of the enclosing scope
+# define CPP08_TIME(probe) \
+    ::instrument::ScopedTimer CPP08_INSTRUMENT_CONCAT(cpp08_timer_, __LINE__)(::instrument::probe)
+// Record one value
+# define CPP08_RECORD(probe, value) ::instrument::record(::instrument::probe, (value))
+#else
+# define CPP08_TIME(probe)
+# define CPP08_RECORD(probe, value)
+#endif
@@ -0,0 +1,356 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <exception>
+#include "easyfind.hpp"
+#include "easyfind_batch.hpp"
+#include "easyfind_sorted.hpp"
+#include "easyfind_index.hpp"
+#include "easyfind_parallel.hpp"
+#include "easyfind_all.hpp"
+#include <thread>
+#include <set>
+#include <algorithm>
+#include <string>
+
+#define CYAN "\033[36m"
+#define RESET "\033[0m"
+
+// Keeps the optimizer from discarding benchmarked results
+static volatile long g_sink;
+
+// Queries of which hit_percent percent are present in a container holding
+// 0, 2, 4, ... (even values hit, odd values miss)
+static std::vector<int> makeQueries(size_t size, int hit_percent, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> position(0, static_cast<int>(size) - 1);
+    std::uniform_int_distribution<> percent(0, 99);
+
+    std::vector<int> queries;
+    queries.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int value = position(gen) * 2;
+        queries.push_back(percent(gen) < hit_percent ? value : value + 1);
+    }
+    return queries;
+}
+
+// Average nanoseconds per lookup over every query
+template<typename Function>
+static double timePerLookup(Function fn, const std::vector<int>& queries) {
+    auto start = std::chrono::steady_clock::now();
+    long found = 0;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        found += fn(queries[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = found;
+    return std::chrono::duration<double, std::nano>(end - start).count() / queries.size();
+}
+
+template<typename Container>
+static void benchLookups(const std::string& name, size_t size, int hit_percent) {
+    Container container;
+    for (size_t i = 0; i < size; ++i) {
+        container.push_back(static_cast<int>(i * 2));
+    }
+    std::vector<int> queries = makeQueries(size, hit_percent, 200000 / size + 2000);
+
+    double throwing = timePerLookup([&container](int value) -> long {
+        try {
+            return *easyfind(container, value) >= 0;
+        }
+        catch (const std::exception&) {
+            return 0;
+        }
+    }, queries);
+    double nothrow = timePerLookup([&container](int value) -> long {
+        return easyfind(container, value, std::nothrow) != container.end();
+    }, queries);
+
+    std::cout << std::setw(14) << name
+              << std::setw(10) << size
+              << std::setw(8) << hit_percent << "%"
+              << std::setw(16) << std::fixed << std::setprecision(1) << throwing
+              << std::setw(16) << nothrow
+              << std::setw(12) << std::setprecision(1) << throwing / nothrow << "x" << std::endl;
+}
+
+// Milliseconds for one batch of k lookups with the given strategy
+template<typename Container>
+static double timeBatch(Container& container, const std::vector<int>& queries, EasyfindBatchStrategy strategy) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<typename Container::iterator> results = easyfindBatch(container, queries.begin(), queries.end(), strategy);
+    auto end = std::chrono::steady_clock::now();
+    g_sink = results.size();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<typename Container>
+static void benchBatch(const std::string& name, size_t size, size_t count) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> dis(0, static_cast<int>(size) * 2);
+    Container container;
+    for (size_t i = 0; i < size; ++i) {
+        container.push_back(dis(gen));
+    }
+    std::vector<int> queries;
+    for (size_t i = 0; i < count; ++i) {
+        queries.push_back(dis(gen));
+    }
+
+    std::cout << std::setw(14) << name << std::setw(10) << size << std::setw(10) << count
+              << std::fixed << std::setprecision(3);
+    // Skip per-query scans that would take seconds
+    if (static_cast<double>(size) * count <= 2e9) {
+        std::cout << std::setw(12) << timeBatch(container, queries, EASYFIND_BATCH_SCAN);
+    } else {
+        std::cout << std::setw(12) << "-";
+    }
+    std::cout << std::setw(12) << timeBatch(container, queries, EASYFIND_BATCH_HASH)
+              << std::setw(12) << timeBatch(container, queries, EASYFIND_BATCH_MERGE)
+              << std::setw(12) << timeBatch(container, queries, EASYFIND_BATCH_AUTO) << std::endl;
+}
+
+static void benchSorted(const std::string& name, const std::vector<int>& sorted_values) {
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<size_t> position(0, sorted_values.size() - 1);
+    std::vector<int> queries;
+    for (size_t i = 0; i < 100000; ++i) {
+        // Half hits, half values just past an element
+        int value = sorted_values[position(gen)];
+        queries.push_back(i % 2 ? value : value + 1);
+    }
+    std::vector<int> few(queries.begin(), queries.begin() + 200);
+
+    double linear = timePerLookup([&sorted_values](int value) -> long {
+        return easyfind(sorted_values, value, std::nothrow) != sorted_values.end();
+    }, few);
+    double lower_bound = timePerLookup([&sorted_values](int value) -> long {
+        std::vector<int>::const_iterator it = std::lower_bound(sorted_values.begin(), sorted_values.end(), value);
+        return it != sorted_values.end() && *it == value;
+    }, queries);
+
+    std::cout << std::setw(12) << name << std::setw(10) << sorted_values.size()
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << linear << std::setw(14) << lower_bound;
+    const EasyfindSearch methods[] = {EASYFIND_SEARCH_BINARY, EASYFIND_SEARCH_INTERPOLATION, EASYFIND_SEARCH_AUTO};
+    for (size_t m = 0; m < 3; ++m) {
+        EasyfindSearch method = methods[m];
+        std::cout << std::setw(14) << timePerLookup([&sorted_values, method](int value) -> long {
+            return easyfindSorted(sorted_values, value, std::nothrow, method) != sorted_values.end();
+        }, queries);
+    }
+    std::cout << std::endl;
+}
+
+static void benchSet(size_t size) {
+    std::set<int> values;
+    std::vector<int> queries;
+    for (size_t i = 0; i < size; ++i) {
+        values.insert(static_cast<int>(i * 3));
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+        queries.push_back(static_cast<int>((i * 7919) % (size * 3)));
+    }
+    double linear = timePerLookup([&values](int value) -> long {
+        return std::find(values.begin(), values.end(), value) != values.end();
+    }, queries);
+    double member = timePerLookup([&values](int value) -> long {
+        return easyfind(values, value, std::nothrow) != values.end();
+    }, queries);
+    std::cout << std::setw(12) << "std::set" << std::setw(10) << size
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << linear << std::setw(14) << member << std::endl;
+}
+
+// Repeated lookups into one large vector: scan, sorted copy, hash index
+static void benchIndexed(size_t size) {
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<> dis(0, static_cast<int>(size) * 4);
+    std::vector<int> values;
+    for (size_t i = 0; i < size; ++i) {
+        values.push_back(dis(gen));
+    }
+    std::vector<int> queries;
+    for (size_t i = 0; i < 100000; ++i) {
+        queries.push_back(i % 2 ? values[i % size] : dis(gen));
+    }
+    std::vector<int> few(queries.begin(), queries.begin() + 200);
+
+    auto start = std::chrono::steady_clock::now();
+    EasyfindIndex<std::vector<int> > index(values);
+    double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    double scan = timePerLookup([&values](int value) -> long {
+        return easyfind(values, value, std::nothrow) != values.end();
+    }, few);
+    double indexed = timePerLookup([&index, &values](int value) -> long {
+        return index.find(value, std::nothrow) != values.end();
+    }, queries);
+
+    std::cout << std::setw(12) << size << std::fixed << std::setprecision(1)
+              << std::setw(14) << scan << std::setw(14) << indexed
+              << std::setw(14) << std::setprecision(2) << build << std::endl;
+}
+
+// Thread scaling on one large vector: a miss scans everything, a hit at
+// 10% of the range shows the early exit
+static void benchParallel(size_t size) {
+    std::vector<int> values(size, 0);
+    values[size / 10] = 1;
+    std::vector<int> miss(5, 2);
+    std::vector<int> hit(5, 1);
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores < 4) {
+        cores = 4;
+    }
+    double single = 0;
+    for (unsigned int threads = 1; threads <= cores; threads *= 2) {
+        double missed = timePerLookup([&values, threads](int value) -> long {
+            return easyfindParallel(values, value, std::nothrow, threads) != values.end();
+        }, miss) / 1e6;
+        double found = timePerLookup([&values, threads](int value) -> long {
+            return easyfindParallel(values, value, std::nothrow, threads) != values.end();
+        }, hit) / 1e6;
+        if (threads == 1) {
+            single = missed;
+        }
+        std::cout << std::setw(12) << size << std::setw(10) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(14) << missed << std::setw(14) << found
+                  << std::setw(12) << single / missed << "x" << std::endl;
+    }
+}
+
+// Full scan (a miss) of a vector of E with easyfind and with std::find
+template<typename E>
+static void benchValueType(const std::string& name, size_t size) {
+    std::vector<E> values(size, static_cast<E>(1));
+    std::vector<int> queries(20, 2);
+    double generic = timePerLookup([&values](int value) -> long {
+        return std::find(values.begin(), values.end(), static_cast<E>(value)) != values.end();
+    }, queries) / 1e3;
+    double fast = timePerLookup([&values](int value) -> long {
+        return easyfind(values, static_cast<E>(value), std::nothrow) != values.end();
+    }, queries) / 1e3;
+    std::cout << std::setw(12) << name << std::setw(10) << size << std::fixed << std::setprecision(1)
+              << std::setw(14) << generic << std::setw(14) << fast
+              << std::setw(12) << generic / fast << "x" << std::endl;
+}
+
+// Every match of 0 in a vector where one element in `every` is 0, with a
+// restart loop over std::find and with easyfindAll
+static void benchAllMatches(size_t size, int every) {
+    std::vector<int> values(size);
+    for (size_t i = 0; i < size; ++i) {
+        values[i] = static_cast<int>(i % static_cast<size_t>(every));
+    }
+    std::vector<int> queries(20, 0);
+    double restart = timePerLookup([&values](int value) -> long {
+        long matches = 0;
+        for (std::vector<int>::iterator it = std::find(values.begin(), values.end(), value);
+             it != values.end(); it = std::find(it + 1, values.end(), value)) {
+            matches += it - values.begin();
+        }
+        return matches;
+    }, queries) / 1e3;
+    double lazy = timePerLookup([&values](int value) -> long {
+        long matches = 0;
+        for (std::vector<int>::iterator it : easyfindAll(values, value)) {
+            matches += it - values.begin();
+        }
+        return matches;
+    }, queries) / 1e3;
+    std::cout << std::setw(12) << size << std::setw(10) << ("1/" + std::to_string(every))
+              << std::fixed << std::setprecision(1) << std::setw(14) << restart << std::setw(14) << lazy
+              << std::setw(12) << restart / lazy << "x" << std::endl;
+}
+
+int main() {
+    std::cout << "=== EASYFIND BENCHMARKS ===" << std::endl;
+    std::cout << "Search instruction set: " << easyfindIsaName(easyfindIsa()) << std::endl;
+
+    std::cout << "\n--- Full scans by element type (us per lookup) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Type" << std::setw(10) << "Size"
+              << std::setw(14) << "std::find" << std::setw(14) << "easyfind"
+              << std::setw(13) << "Speedup" << RESET << std::endl;
+    benchValueType<unsigned char>("uint8_t", 1000000);
+    benchValueType<short>("int16_t", 1000000);
+    benchValueType<int>("int32_t", 1000000);
+    benchValueType<long long>("int64_t", 1000000);
+    benchValueType<float>("float", 1000000);
+
+    std::cout << "\n--- All matches in std::vector<int> (us per query) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Size" << std::setw(10) << "Matches"
+              << std::setw(14) << "find loop" << std::setw(14) << "easyfindAll"
+              << std::setw(13) << "Speedup" << RESET << std::endl;
+    benchAllMatches(1000000, 2);
+    benchAllMatches(1000000, 16);
+    benchAllMatches(1000000, 1000);
+
+    std::cout << "\n--- Throwing vs nothrow lookups (ns per lookup) ---" << std::endl;
+    std::cout << CYAN << std::setw(14) << "Container" << std::setw(10) << "Size"
+              << std::setw(9) << "Hits" << std::setw(16) << "throwing"
+              << std::setw(16) << "nothrow" << std::setw(13) << "Speedup" << RESET << std::endl;
+
+    const size_t sizes[] = {16, 256, 4096};
+    const int hit_percents[] = {90, 10};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        for (size_t h = 0; h < sizeof(hit_percents) / sizeof(hit_percents[0]); ++h) {
+            benchLookups<std::vector<int> >("std::vector", sizes[s], hit_percents[h]);
+            benchLookups<std::deque<int> >("std::deque", sizes[s], hit_percents[h]);
+            benchLookups<std::list<int> >("std::list", sizes[s], hit_percents[h]);
+        }
+    }
+
+    std::cout << "\n--- Batch lookups (ms per batch) ---" << std::endl;
+    std::cout << CYAN << std::setw(14) << "Container" << std::setw(10) << "Size"
+              << std::setw(10) << "Queries" << std::setw(12) << "scan" << std::setw(12) << "hash"
+              << std::setw(12) << "merge" << std::setw(12) << "auto" << RESET << std::endl;
+    const size_t counts[] = {4, 16, 64, 1000, 100000, 1000000};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        benchBatch<std::vector<int> >("std::vector", 100000, counts[c]);
+        benchBatch<std::list<int> >("std::list", 100000, counts[c]);
+    }
+
+    std::cout << "\n--- Sorted lookups (ns per lookup) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Data" << std::setw(10) << "Size"
+              << std::setw(14) << "linear" << std::setw(14) << "lower_bound" << std::setw(14) << "binary"
+              << std::setw(14) << "interp." << std::setw(14) << "auto" << RESET << std::endl;
+    const size_t sorted_sizes[] = {1000, 1000000};
+    for (size_t s = 0; s < sizeof(sorted_sizes) / sizeof(sorted_sizes[0]); ++s) {
+        std::vector<int> uniform;
+        std::vector<int> skewed;
+        for (size_t i = 0; i < sorted_sizes[s]; ++i) {
+            uniform.push_back(static_cast<int>(i * 1000));
+            skewed.push_back(static_cast<int>(i * i / 1000));
+        }
+        benchSorted("uniform", uniform);
+        benchSorted("skewed", skewed);
+    }
+
+    std::cout << "\n--- Set lookups (ns per lookup) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Container" << std::setw(10) << "Size"
+              << std::setw(14) << "std::find" << std::setw(14) << "easyfind" << RESET << std::endl;
+    benchSet(1000);
+    benchSet(100000);
+
+    std::cout << "\n--- Indexed lookups into std::vector (ns per lookup) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Size" << std::setw(14) << "easyfind"
+              << std::setw(14) << "index" << std::setw(14) << "build (ms)" << RESET << std::endl;
+    benchIndexed(1000);
+    benchIndexed(1000000);
+
+    std::cout << "\n--- Parallel easyfind (ms per lookup, " << std::thread::hardware_concurrency()
+              << " cores) ---" << std::endl;
+    std::cout << CYAN << std::setw(12) << "Size" << std::setw(10) << "Threads"
+              << std::setw(14) << "miss" << std::setw(14) << "hit at 10%"
+              << std::setw(13) << "Speedup" << RESET << std::endl;
+    benchParallel(1 << 26);
+    return 0;
+}
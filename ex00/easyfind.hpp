@@ -1,18 +1,191 @@
 #pragma once
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <stdexcept>
+#include <new>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include "easyfind_simd.hpp"
+#include "instrument.hpp"
+
+namespace easyfind_detail {
+
+/**
+ * Convert value to Target if Target can hold it exactly. Integers are
+ * compared by value, like std::cmp_equal: -1 never matches an unsigned
+ * element and 300 never matches a uint8_t, whereas std::find's implicit
+ * conversions would let -1 match UINT_MAX.
+ * @return false when no Target compares equal to value
+ */
+template<typename Target, typename Value>
+bool fitsIn(const Value& value, Target& out)
+{
+    if constexpr (std::is_integral_v<Target> && std::is_integral_v<Value>) {
+        if constexpr (std::is_signed_v<Value>) {
+            long long wide = value;
+            if (wide < 0) {
+                if (!std::is_signed_v<Target> || wide < static_cast<long long>(std::numeric_limits<Target>::min()))
+                    return false;
+            } else if (static_cast<unsigned long long>(wide)
+                       > static_cast<unsigned long long>(std::numeric_limits<Target>::max())) {
+                return false;
+            }
+        } else if (static_cast<unsigned long long>(value)
+                   > static_cast<unsigned long long>(std::numeric_limits<Target>::max())) {
+            return false;
+        }
+    }
+    out = static_cast<Target>(value);
+    return true;
+}
+
+// Containers whose elements are their keys (sets, not maps)
+template<typename T>
+concept SetLike = requires { typename T::key_type; }
+               && std::is_same_v<typename T::key_type, typename T::value_type>;
+
+// std::set, std::multiset: logarithmic lower_bound under key_comp()
+template<typename T>
+concept OrderedSet = SetLike<T> && requires(T& c, const typename T::key_type& key) {
+    c.lower_bound(key);
+    c.key_comp();
+};
+
+// std::unordered_set, std::unordered_multiset: hashed find
+template<typename T>
+concept HashedSet = SetLike<T> && requires(T& c, const typename T::key_type& key) {
+    c.find(key);
+    c.hash_function();
+};
+
+} // namespace easyfind_detail
+
+/**
+ * First occurrence of value in [first, last)
+ * The search is picked at compile time from the element type:
+ * - contiguous byte-sized integers (char, uint8_t, ...): memchr
+ * - contiguous 16/32/64-bit integers: the SIMD kernels in easyfind_simd.hpp
+ * - any other integer range (std::list, std::deque, ...): std::find on the
+ *   value converted to the element type
+ * - everything else (float, double, class types): std::find as is
+ * An integer value the element type cannot represent is reported as not
+ * found without scanning.
+ */
+template<typename Iterator, typename V>
+Iterator easyfindRange(Iterator first, Iterator last, const V& value)
+{
+    typedef std::iter_value_t<Iterator> Element;
+
+    if constexpr (std::is_integral_v<Element> && std::is_integral_v<V>) {
+        Element key;
+        if (!easyfind_detail::fitsIn(value, key))
+            return last;
+        if constexpr (std::contiguous_iterator<Iterator> && easyfind_detail::hasFastSearch<Element>) {
+            std::size_t count = static_cast<std::size_t>(last - first);
+            return first + easyfindOffset(std::to_address(first), count, key);
+        } else {
+            return std::find(first, last, key);
+        }
+    } else {
+        return std::find(first, last, value);
+    }
+}
+
+namespace easyfind_detail {
+
+// A set's own lookup for key (see easyfindIn)
+template<typename T, typename K>
+auto setLookup(T& container, const K& key) -> decltype(container.begin())
+{
+    if constexpr (OrderedSet<std::remove_const_t<T> >) {
+        auto it = container.lower_bound(key);
+        if (it != container.end() && !container.key_comp()(key, *it))
+            return it;
+        return container.end();
+    } else {
+        return container.find(key);
+    }
+}
+
+// Pick the search for this container (see easyfindIn)
+template<typename T, typename V>
+auto lookup(T& container, const V& value) -> decltype(container.begin())
+{
+    typedef std::remove_const_t<T> Container;
+
+    if constexpr (OrderedSet<Container> || HashedSet<Container>) {
+        typedef typename Container::key_type Key;
+        // Only integer keys are converted up front; other key types need
+        // not be default-constructible and compare as they are
+        if constexpr (std::is_integral_v<Key> && std::is_integral_v<V>) {
+            Key key;
+            if (!fitsIn(value, key))
+                return container.end();
+            return setLookup(container, key);
+        } else {
+            return setLookup(container, value);
+        }
+    } else {
+        return easyfindRange(container.begin(), container.end(), value);
+    }
+}
+
+#ifdef CPP08_INSTRUMENT
+// lookup(), timed as a hit or a miss; linear searches also record how many
+// elements they compared (std::distance is O(n) on lists, instrumented
+// builds only)
+template<typename T, typename V>
+auto instrumentedLookup(T& container, const V& value) -> decltype(container.begin())
+{
+    typedef std::remove_const_t<T> Container;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    auto it = lookup(container, value);
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    bool hit = it != container.end();
+    instrument::record(hit ? instrument::EASYFIND_HIT : instrument::EASYFIND_MISS,
+                       static_cast<std::uint64_t>(elapsed.count()));
+    if constexpr (!OrderedSet<Container> && !HashedSet<Container>) {
+        std::ptrdiff_t scanned = std::distance(container.begin(), it) + (hit ? 1 : 0);
+        instrument::record(instrument::EASYFIND_SCAN, static_cast<std::uint64_t>(scanned));
+    }
+    return it;
+}
+#endif
+
+} // namespace easyfind_detail
+
+/**
+ * First occurrence of value in a container, using what the container knows
+ * about its layout: sets are searched with their own lower_bound / find,
+ * everything else goes through easyfindRange.
+ * For multisets lower_bound (rather than find) returns the first of several
+ * equal elements in iteration order, like a linear scan would.
+ */
+template<typename T, typename V>
+auto easyfindIn(T& container, const V& value) -> decltype(container.begin())
+{
+#ifdef CPP08_INSTRUMENT
+    return easyfind_detail::instrumentedLookup(container, value);
+#else
+    return easyfind_detail::lookup(container, value);
+#endif
+}
 
 /**
  * Template function to find the first occurrence of a value in a container
  * @param container The container to search in (type T)
- * @param value The integer value to find
+ * @param value The value to find (any type comparable with the elements)
  * @return Iterator to the first occurrence of the value
  * @throws std::runtime_error if the value is not found
  */
-template<typename T>
-typename T::iterator easyfind(T& container, int value)
+template<typename T, typename V>
+typename T::iterator easyfind(T& container, const V& value)
 {
-    typename T::iterator it = std::find(container.begin(), container.end(), value);
+    typename T::iterator it = easyfindIn(container, value);
     
     if (it == container.end())
         throw std::runtime_error("Value not found in container");
@@ -23,17 +196,44 @@ typename T::iterator easyfind(T& container, int value)
 /**
  * Const version of easyfind for const containers
  * @param container The const container to search in (type T)
- * @param value The integer value to find
+ * @param value The value to find (any type comparable with the elements)
  * @return Const iterator to the first occurrence of the value
  * @throws std::runtime_error if the value is not found
  */
-template<typename T>
-typename T::const_iterator easyfind(const T& container, int value)
+template<typename T, typename V>
+typename T::const_iterator easyfind(const T& container, const V& value)
 {
-    typename T::const_iterator it = std::find(container.begin(), container.end(), value);
+    typename T::const_iterator it = easyfindIn(container, value);
     
     if (it == container.end())
         throw std::runtime_error("Value not found in container");
     
     return it;
 }
+
+/**
+ * Non-throwing easyfind for lookup loops where misses are common
+ * Usage mirrors new (std::nothrow): easyfind(container, value, std::nothrow)
+ * Only a miss is reported without throwing; an exception from comparing
+ * elements still propagates to the caller.
+ * @param container The container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @return Iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::iterator easyfind(T& container, const V& value, const std::nothrow_t&)
+{
+    return easyfindIn(container, value);
+}
+
+/**
+ * Non-throwing easyfind for const containers
+ * @param container The const container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @return Const iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::const_iterator easyfind(const T& container, const V& value, const std::nothrow_t&)
+{
+    return easyfindIn(container, value);
+}
@@ -0,0 +1,307 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include "easyfind.hpp"
+
+/**
+ * Lazy multi-match search.
+ *
+ * easyfindAll(container, value) and easyfindIf(container, predicate) return
+ * a light range whose elements are container iterators, one per match, in
+ * container order. Nothing is collected up front: each step of the range
+ * resumes the scan where the previous match was found.
+ *
+ *     for (auto it : easyfindAll(vec, 42))
+ *         positions.push_back(it - vec.begin());
+ *
+ * On contiguous integer storage easyfindAll compares 64 elements at a time
+ * into a bitmask (easyfindMatchMask) and then walks the set bits, so dense
+ * matches cost one bit-scan each rather than one compare-and-branch per
+ * element. Other containers restart easyfindRange after each match.
+ *
+ * The range refers to the container, which must outlive it and must not be
+ * modified while it is iterated.
+ */
+
+namespace easyfind_detail {
+
+template<typename Iterator, typename V>
+inline constexpr bool maskedSearch = std::contiguous_iterator<Iterator>
+                                  && hasFastSearch<std::iter_value_t<Iterator> >
+                                  && std::is_integral_v<V>;
+
+} // namespace easyfind_detail
+
+template<typename Iterator, typename V>
+class EasyfindMatches {
+private:
+    static constexpr bool MASKED = easyfind_detail::maskedSearch<Iterator, V>;
+    // Element type for the masked scan; unused (and any type would do) otherwise
+    typedef std::conditional_t<MASKED, std::iter_value_t<Iterator>, char> Element;
+
+    Iterator _first;
+    Iterator _last;
+    V _value;
+
+public:
+    class iterator {
+    private:
+        Iterator _first;
+        Iterator _last;
+        Iterator _current;      // Current match (generic scan)
+        Element _key;           // Value as an element (masked scan)
+        std::size_t _count;
+        std::size_t _block;     // First position of the current mask block
+        std::uint64_t _mask;    // Matches left in the current block
+        V _value;
+
+        // Load blocks until one has a match, or run off the end
+        void nextBlock() {
+            const Element* data = std::to_address(_first);
+            while (_mask == 0) {
+                _block += EASYFIND_MASK_BLOCK;
+                if (_block >= _count) {
+                    _block = _count;
+                    return;
+                }
+                std::size_t length = std::min(EASYFIND_MASK_BLOCK, _count - _block);
+                _mask = easyfindMatchMask(data + _block, length, _key);
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Iterator value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Iterator* pointer;
+        typedef Iterator reference;
+
+        iterator() : _key(), _count(0), _block(0), _mask(0), _value() {}
+
+        iterator(Iterator first, Iterator last, const V& value)
+            : _first(first), _last(last), _current(last), _key(), _count(0), _block(0), _mask(0), _value(value) {
+            if constexpr (MASKED) {
+                _count = static_cast<std::size_t>(last - first);
+                if (!easyfind_detail::fitsIn(value, _key)) {
+                    _block = _count;
+                    return;
+                }
+                // Start one block early so nextBlock() loads block 0
+                _block = static_cast<std::size_t>(0) - EASYFIND_MASK_BLOCK;
+                nextBlock();
+            } else {
+                _current = easyfindRange(first, last, value);
+            }
+        }
+
+        Iterator operator*() const {
+            if constexpr (MASKED)
+                return _first + (_block + static_cast<std::size_t>(__builtin_ctzll(_mask)));
+            else
+                return _current;
+        }
+
+        iterator& operator++() {
+            if constexpr (MASKED) {
+                _mask &= _mask - 1;
+                nextBlock();
+            } else {
+                _current = easyfindRange(std::next(_current), _last, _value);
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool atEnd() const {
+            if constexpr (MASKED)
+                return _block >= _count;
+            else
+                return _current == _last;
+        }
+
+        bool operator==(const iterator& other) const {
+            return atEnd() == other.atEnd() && (atEnd() || **this == *other);
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return atEnd();
+        }
+    };
+
+    EasyfindMatches(Iterator first, Iterator last, const V& value)
+        : _first(first), _last(last), _value(value) {}
+
+    iterator begin() const {
+        return iterator(_first, _last, _value);
+    }
+
+    std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+
+    bool empty() const {
+        return begin().atEnd();
+    }
+
+    // Number of matches (walks the whole range)
+    std::size_t count() const {
+        std::size_t matches = 0;
+        for (iterator it = begin(); !it.atEnd(); ++it)
+            ++matches;
+        return matches;
+    }
+};
+
+template<typename Iterator, typename Predicate>
+class EasyfindIfMatches {
+private:
+    Iterator _first;
+    Iterator _last;
+    Predicate _predicate;
+
+public:
+    class iterator {
+    private:
+        Iterator _current;
+        Iterator _last;
+        // Held by value so the iterator outlives the range it came from;
+        // optional because lambdas are neither default-constructible nor
+        // assignable once they capture
+        std::optional<Predicate> _predicate;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Iterator value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Iterator* pointer;
+        typedef Iterator reference;
+
+        iterator() {}
+
+        iterator(Iterator first, Iterator last, const Predicate& predicate)
+            : _current(std::find_if(first, last, predicate)), _last(last), _predicate(predicate) {}
+
+        iterator(const iterator& other)
+            : _current(other._current), _last(other._last), _predicate(other._predicate) {}
+
+        iterator& operator=(const iterator& other) {
+            if (this != &other) {
+                _current = other._current;
+                _last = other._last;
+                _predicate.reset();
+                if (other._predicate)
+                    _predicate.emplace(*other._predicate);
+            }
+            return *this;
+        }
+
+        Iterator operator*() const {
+            return _current;
+        }
+
+        iterator& operator++() {
+            _current = std::find_if(std::next(_current), _last, *_predicate);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool atEnd() const {
+            return _current == _last;
+        }
+
+        bool operator==(const iterator& other) const {
+            return _current == other._current;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return atEnd();
+        }
+    };
+
+    EasyfindIfMatches(Iterator first, Iterator last, const Predicate& predicate)
+        : _first(first), _last(last), _predicate(predicate) {}
+
+    // Each iterator carries its own copy of the predicate
+    iterator begin() const {
+        return iterator(_first, _last, _predicate);
+    }
+
+    std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+
+    bool empty() const {
+        return begin().atEnd();
+    }
+
+    // Number of matches (walks the whole range)
+    std::size_t count() const {
+        std::size_t matches = 0;
+        for (iterator it = begin(); !it.atEnd(); ++it)
+            ++matches;
+        return matches;
+    }
+};
+
+/**
+ * Every occurrence of a value, lazily
+ * @param container The container to search in (type T)
+ * @param value The value to find
+ * @return A range of iterators into container, one per match, in order
+ */
+template<typename T, typename V>
+EasyfindMatches<typename T::iterator, V> easyfindAll(T& container, const V& value)
+{
+    return EasyfindMatches<typename T::iterator, V>(container.begin(), container.end(), value);
+}
+
+/**
+ * Const version of easyfindAll for const containers
+ * @param container The const container to search in (type T)
+ * @param value The value to find
+ * @return A range of const iterators into container, one per match, in order
+ */
+template<typename T, typename V>
+EasyfindMatches<typename T::const_iterator, V> easyfindAll(const T& container, const V& value)
+{
+    return EasyfindMatches<typename T::const_iterator, V>(container.begin(), container.end(), value);
+}
+
+/**
+ * Every element satisfying a predicate, lazily
+ * @param container The container to search in (type T)
+ * @param predicate Called with each element; matches where it returns true
+ * @return A range of iterators into container, one per match, in order
+ */
+template<typename T, typename Predicate>
+EasyfindIfMatches<typename T::iterator, Predicate> easyfindIf(T& container, Predicate predicate)
+{
+    return EasyfindIfMatches<typename T::iterator, Predicate>(container.begin(), container.end(), predicate);
+}
+
+/**
+ * Const version of easyfindIf for const containers
+ * @param container The const container to search in (type T)
+ * @param predicate Called with each element; matches where it returns true
+ * @return A range of const iterators into container, one per match, in order
+ */
+template<typename T, typename Predicate>
+EasyfindIfMatches<typename T::const_iterator, Predicate> easyfindIf(const T& container, Predicate predicate)
+{
+    return EasyfindIfMatches<typename T::const_iterator, Predicate>(container.begin(), container.end(), predicate);
+}
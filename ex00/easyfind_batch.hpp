@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "easyfind.hpp"
+
+/**
+ * Batch lookups: the first occurrence of each of k query values in a
+ * container of n elements. Misses are reported as container.end().
+ *
+ * Strategies:
+ * - SCAN:  one easyfind per query, O(n·k) but SIMD-fast on contiguous ints
+ * - HASH:  one pass over the container probing a hash table of the distinct
+ *          queries, O(n + k), stopping once every query has been found
+ * - MERGE: sort the container's (value, position) pairs and the queries,
+ *          then merge, O(n log n + k log k) with no hashing
+ *
+ * EASYFIND_BATCH_AUTO scans while k is small and hashes otherwise. MERGE is
+ * never picked automatically: on 10^5 elements it lost to HASH at every k
+ * from 4 to 10^6, but it stays available for inputs that hash badly.
+ */
+enum EasyfindBatchStrategy {
+    EASYFIND_BATCH_AUTO,
+    EASYFIND_BATCH_SCAN,
+    EASYFIND_BATCH_HASH,
+    EASYFIND_BATCH_MERGE
+};
+
+// Largest k for which AUTO runs one scan per query (a SIMD scan costs
+// about 1/100 of a hashed pass, a pointer-chasing scan about 1/2)
+const std::size_t EASYFIND_BATCH_SCAN_MAX_CONTIGUOUS = 64;
+const std::size_t EASYFIND_BATCH_SCAN_MAX = 2;
+
+namespace easyfind_detail {
+
+template<typename Iterator, typename Key>
+void batchScan(Iterator first, Iterator last, const std::vector<Key>& queries,
+               std::vector<Iterator>& results)
+{
+    for (std::size_t q = 0; q < queries.size(); ++q)
+        results[q] = easyfindRange(first, last, queries[q]);
+}
+
+/**
+ * Open-addressing table of distinct integer keys, each numbered in
+ * insertion order. Linear probing over a power-of-two array at most half
+ * full keeps a probe to one or two cache lines, which std::unordered_map
+ * cannot.
+ */
+template<typename Key>
+class QueryTable {
+private:
+    static constexpr std::uint32_t EMPTY = 0xFFFFFFFFu;
+
+    std::vector<Key> _keys;
+    std::vector<std::uint32_t> _ids;
+    std::size_t _mask;
+    unsigned int _shift;
+    std::size_t _size;
+
+    std::size_t home(Key key) const
+    {
+        // Fibonacci hashing: the top bits of a multiplicative hash
+        std::uint64_t hash = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> _shift) & _mask;
+    }
+
+public:
+    explicit QueryTable(std::size_t expected) : _size(0)
+    {
+        std::size_t capacity = 16;
+        unsigned int bits = 4;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+            ++bits;
+        }
+        _keys.assign(capacity, Key());
+        _ids.assign(capacity, EMPTY);
+        _mask = capacity - 1;
+        _shift = bits >= 64 ? 0 : 64 - bits;
+    }
+
+    // Id of key, inserting it with the next id if absent
+    std::size_t insert(Key key)
+    {
+        std::size_t slot = home(key);
+        while (_ids[slot] != EMPTY) {
+            if (_keys[slot] == key)
+                return _ids[slot];
+            slot = (slot + 1) & _mask;
+        }
+        _keys[slot] = key;
+        _ids[slot] = static_cast<std::uint32_t>(_size);
+        return _size++;
+    }
+
+    // Id of key, or size() if absent
+    std::size_t find(Key key) const
+    {
+        std::size_t slot = home(key);
+        while (_ids[slot] != EMPTY) {
+            if (_keys[slot] == key)
+                return _ids[slot];
+            slot = (slot + 1) & _mask;
+        }
+        return _size;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+};
+
+// Queries are already in the element type, so elements are keys as they are
+template<typename Iterator, typename Key>
+void batchHash(Iterator first, Iterator last, const std::vector<Key>& queries,
+               std::vector<Iterator>& results)
+{
+    // Distinct query values, numbered; queryIds maps each query to its number
+    QueryTable<Key> table(queries.size());
+    std::vector<std::size_t> queryIds(queries.size());
+    for (std::size_t q = 0; q < queries.size(); ++q)
+        queryIds[q] = table.insert(queries[q]);
+
+    std::vector<Iterator> found(table.size(), last);
+    std::vector<bool> seen(table.size(), false);
+    std::size_t remaining = table.size();
+    for (Iterator it = first; it != last && remaining > 0; ++it) {
+        std::size_t id = table.find(*it);
+        if (id != table.size() && !seen[id]) {
+            seen[id] = true;
+            found[id] = it;
+            --remaining;
+        }
+    }
+
+    for (std::size_t q = 0; q < queries.size(); ++q)
+        results[q] = found[queryIds[q]];
+}
+
+template<typename Iterator, typename Key>
+void batchMerge(Iterator first, Iterator last, const std::vector<Key>& queries,
+                std::vector<Iterator>& results)
+{
+    // Stable sort keeps equal values in container order, so the first of a
+    // run of equal values is the first occurrence
+    std::vector<std::pair<Key, Iterator> > elements;
+    for (Iterator it = first; it != last; ++it)
+        elements.push_back(std::make_pair(*it, it));
+    std::stable_sort(elements.begin(), elements.end(),
+        [](const std::pair<Key, Iterator>& a, const std::pair<Key, Iterator>& b) {
+            return a.first < b.first;
+        });
+
+    std::vector<std::size_t> order(queries.size());
+    for (std::size_t q = 0; q < order.size(); ++q)
+        order[q] = q;
+    std::sort(order.begin(), order.end(), [&queries](std::size_t a, std::size_t b) {
+        return queries[a] < queries[b];
+    });
+
+    std::size_t e = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        Key value = queries[order[i]];
+        while (e < elements.size() && elements[e].first < value)
+            ++e;
+        results[order[i]] = e < elements.size() && elements[e].first == value
+                          ? elements[e].second : last;
+    }
+}
+
+template<typename Iterator>
+EasyfindBatchStrategy chooseBatchStrategy(std::size_t k)
+{
+    bool contiguous = std::contiguous_iterator<Iterator>
+                   && hasFastSearch<std::iter_value_t<Iterator> >;
+    if (k <= (contiguous ? EASYFIND_BATCH_SCAN_MAX_CONTIGUOUS : EASYFIND_BATCH_SCAN_MAX))
+        return EASYFIND_BATCH_SCAN;
+    return EASYFIND_BATCH_HASH;
+}
+
+} // namespace easyfind_detail
+
+/**
+ * First occurrence of every query value in [first, last)
+ * On integer elements each query is first converted to the element type,
+ * as in easyfindRange: a query the element type cannot represent is a
+ * miss, never a match on its truncated value.
+ * @param first, last The range to search
+ * @param qFirst, qLast The query values (any input range)
+ * @param strategy How to search; AUTO picks from the query count and container kind
+ * @return One iterator per query, in query order; last where not found
+ */
+template<typename Iterator, typename QueryIterator>
+std::vector<Iterator> easyfindBatchRange(Iterator first, Iterator last,
+                                         QueryIterator qFirst, QueryIterator qLast,
+                                         EasyfindBatchStrategy strategy = EASYFIND_BATCH_AUTO)
+{
+    typedef std::iter_value_t<Iterator> Element;
+    typedef std::iter_value_t<QueryIterator> Query;
+
+    if constexpr (std::is_integral_v<Element> && std::is_integral_v<Query>) {
+        // Keys in the element type; slots[i] is the query keys[i] came from
+        std::vector<Element> keys;
+        std::vector<std::size_t> slots;
+        std::size_t count = 0;
+        for (; qFirst != qLast; ++qFirst, ++count) {
+            Element key;
+            if (easyfind_detail::fitsIn(*qFirst, key)) {
+                keys.push_back(key);
+                slots.push_back(count);
+            }
+        }
+        std::vector<Iterator> results(count, last);
+        if (keys.empty() || first == last)
+            return results;
+
+        if (strategy == EASYFIND_BATCH_AUTO)
+            strategy = easyfind_detail::chooseBatchStrategy<Iterator>(keys.size());
+        std::vector<Iterator> found(keys.size(), last);
+        if (strategy == EASYFIND_BATCH_HASH)
+            easyfind_detail::batchHash(first, last, keys, found);
+        else if (strategy == EASYFIND_BATCH_MERGE)
+            easyfind_detail::batchMerge(first, last, keys, found);
+        else
+            easyfind_detail::batchScan(first, last, keys, found);
+        for (std::size_t k = 0; k < keys.size(); ++k)
+            results[slots[k]] = found[k];
+        return results;
+    } else {
+        // Hashing and merging need integer keys; anything else is scanned
+        std::vector<Query> queries(qFirst, qLast);
+        std::vector<Iterator> results(queries.size(), last);
+        if (!queries.empty() && first != last)
+            easyfind_detail::batchScan(first, last, queries, results);
+        return results;
+    }
+}
+
+/**
+ * Batch version of easyfind
+ * @param container The container to search in (type T)
+ * @param qFirst, qLast The query values
+ * @param strategy How to search; AUTO picks from the query count and container kind
+ * @return One iterator per query, in query order; container.end() where not found
+ */
+template<typename T, typename QueryIterator>
+std::vector<typename T::iterator> easyfindBatch(T& container, QueryIterator qFirst, QueryIterator qLast,
+                                                EasyfindBatchStrategy strategy = EASYFIND_BATCH_AUTO)
+{
+    return easyfindBatchRange(container.begin(), container.end(), qFirst, qLast, strategy);
+}
+
+/**
+ * Batch version of easyfind for const containers
+ * @param container The const container to search in (type T)
+ * @param qFirst, qLast The query values
+ * @param strategy How to search; AUTO picks from the query count and container kind
+ * @return One const iterator per query, in query order; container.end() where not found
+ */
+template<typename T, typename QueryIterator>
+std::vector<typename T::const_iterator> easyfindBatch(const T& container, QueryIterator qFirst, QueryIterator qLast,
+                                                      EasyfindBatchStrategy strategy = EASYFIND_BATCH_AUTO)
+{
+    return easyfindBatchRange(container.begin(), container.end(), qFirst, qLast, strategy);
+}
@@ -0,0 +1,236 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "easyfind.hpp"
+
+/**
+ * EasyfindIndex - O(1) first-occurrence lookups into a container that is
+ * searched far more often than it changes
+ *
+ * The index is an open-addressing hash table from value to the position of
+ * its first occurrence. Each slot holds the key, in the element type, next
+ * to its position (8 bytes for int elements), so a lookup touches one cache
+ * line in the common case. Elements must be integers; a query the element
+ * type cannot represent is a miss, as in easyfind.
+ * Positions rather than iterators are stored, so the index survives
+ * reallocation of a std::vector; iterators are rebuilt from begin() on
+ * every lookup.
+ *
+ * The index does not observe the container. After changing it, either
+ * call indexAppended() (elements were only added at the end), rebuild(),
+ * or invalidate(). An invalidated index answers with a plain easyfind scan
+ * until it is rebuilt, so results always match easyfind, including which
+ * of several equal elements is returned.
+ */
+template<typename Container>
+class EasyfindIndex {
+public:
+    typedef decltype(std::declval<Container&>().begin()) iterator;
+    typedef std::iter_value_t<iterator> Key;
+
+    // position() result for values that are not in the container
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+    static constexpr std::uint32_t EMPTY = 0xFFFFFFFFu;
+
+    struct Slot {
+        Key key;
+        std::uint32_t position;
+    };
+
+    Container* _container;
+    std::vector<Slot> _slots;
+    std::size_t _mask;
+    unsigned int _shift;
+    std::size_t _keys;      // Distinct values in the table
+    std::size_t _indexed;   // Leading elements of the container covered
+    bool _valid;
+
+    std::size_t home(Key key) const {
+        // Fibonacci hashing: the top bits of a multiplicative hash
+        std::uint64_t hash = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(hash >> _shift) & _mask;
+    }
+
+    // Size the table for expected distinct keys at a load of at most 1/2
+    void reserveSlots(std::size_t expected) {
+        std::size_t capacity = 16;
+        unsigned int bits = 4;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+            ++bits;
+        }
+        if (capacity <= _slots.size()) {
+            return;
+        }
+
+        std::vector<Slot> old;
+        old.swap(_slots);
+        Slot empty = {Key(), EMPTY};
+        _slots.assign(capacity, empty);
+        _mask = capacity - 1;
+        _shift = bits >= 64 ? 0 : 64 - bits;
+        _keys = 0;
+        for (std::size_t i = 0; i < old.size(); ++i) {
+            if (old[i].position != EMPTY) {
+                place(old[i].key, old[i].position);
+            }
+        }
+    }
+
+    // Record key at position unless an earlier occurrence is already there
+    void place(Key key, std::uint32_t position) {
+        std::size_t slot = home(key);
+        while (_slots[slot].position != EMPTY) {
+            if (_slots[slot].key == key) {
+                return;
+            }
+            slot = (slot + 1) & _mask;
+        }
+        _slots[slot].key = key;
+        _slots[slot].position = position;
+        ++_keys;
+    }
+
+    // Index the elements in [_indexed, size())
+    void indexFrom(std::size_t first) {
+        std::size_t count = static_cast<std::size_t>(_container->size());
+        if (count >= EMPTY) {
+            throw std::length_error("Container too large for EasyfindIndex");
+        }
+        reserveSlots(_keys + (count - first));
+
+        iterator it = _container->begin() + first;
+        for (std::size_t position = first; position < count; ++position, ++it) {
+            place(*it, static_cast<std::uint32_t>(position));
+        }
+        _indexed = count;
+        _valid = true;
+    }
+
+public:
+    // Constructor: builds the index over the container's current contents
+    explicit EasyfindIndex(Container& container)
+        : _container(&container), _mask(0), _shift(64), _keys(0), _indexed(0), _valid(false) {
+        static_assert(std::random_access_iterator<iterator>,
+                      "EasyfindIndex needs a random-access container");
+        static_assert(std::is_integral_v<Key>, "EasyfindIndex needs an integer element type");
+        indexFrom(0);
+    }
+
+    // Copy constructor
+    EasyfindIndex(const EasyfindIndex& other)
+        : _container(other._container), _slots(other._slots), _mask(other._mask), _shift(other._shift),
+          _keys(other._keys), _indexed(other._indexed), _valid(other._valid) {}
+
+    // Assignment operator
+    EasyfindIndex& operator=(const EasyfindIndex& other) {
+        if (this != &other) {
+            _container = other._container;
+            _slots = other._slots;
+            _mask = other._mask;
+            _shift = other._shift;
+            _keys = other._keys;
+            _indexed = other._indexed;
+            _valid = other._valid;
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~EasyfindIndex() {}
+
+    // Rebuild from scratch after arbitrary changes to the container
+    void rebuild() {
+        _slots.clear();
+        _keys = 0;
+        _indexed = 0;
+        indexFrom(0);
+    }
+
+    // Bring the index up to date after elements were only appended. Falls
+    // back to a full rebuild if the container shrank in the meantime.
+    void indexAppended() {
+        if (!_valid || _container->size() < _indexed) {
+            rebuild();
+        } else {
+            indexFrom(_indexed);
+        }
+    }
+
+    // Mark the index stale; lookups scan until rebuild()
+    void invalidate() {
+        _valid = false;
+    }
+
+    bool valid() const {
+        return _valid;
+    }
+
+    /**
+     * Position of the first occurrence of value
+     * @param value The integer value to find
+     * @return Zero-based position, or npos if the value is not present
+     */
+    template<typename V>
+    std::size_t position(const V& value) const {
+        // Stale index, or a non-integer query that easyfind compares as is
+        if (!_valid || !std::is_integral_v<V>) {
+            iterator it = easyfindIn(*_container, value);
+            return it == _container->end() ? npos : static_cast<std::size_t>(it - _container->begin());
+        }
+        Key key;
+        if (!easyfind_detail::fitsIn(value, key)) {
+            return npos;
+        }
+        std::size_t slot = home(key);
+        while (_slots[slot].position != EMPTY) {
+            if (_slots[slot].key == key) {
+                return _slots[slot].position;
+            }
+            slot = (slot + 1) & _mask;
+        }
+        return npos;
+    }
+
+    /**
+     * Indexed easyfind
+     * @param value The integer value to find
+     * @return Iterator to the first occurrence of the value
+     * @throws std::runtime_error if the value is not found
+     */
+    template<typename V>
+    iterator find(const V& value) const {
+        std::size_t found = position(value);
+
+        if (found == npos)
+            throw std::runtime_error("Value not found in container");
+
+        return _container->begin() + found;
+    }
+
+    /**
+     * Non-throwing indexed easyfind
+     * Only a miss is reported without throwing; while the index is invalid
+     * the easyfind scan it falls back to may still throw.
+     * @param value The integer value to find
+     * @return Iterator to the first occurrence of the value, or the container's end()
+     */
+    template<typename V>
+    iterator find(const V& value, const std::nothrow_t&) const {
+        std::size_t found = position(value);
+        return found == npos ? _container->end() : _container->begin() + found;
+    }
+
+    // Number of distinct values indexed
+    std::size_t distinctValues() const {
+        return _keys;
+    }
+};
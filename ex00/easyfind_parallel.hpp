@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "easyfind.hpp"
+
+/**
+ * Multi-threaded easyfind for very large random-access ranges.
+ *
+ * The range is cut into blocks handed out in ascending order from a shared
+ * counter. Workers scan their block in slices (with the SIMD kernels on
+ * contiguous ints) and lower a shared "earliest match" index with a CAS.
+ * A worker stops as soon as the slice it is about to scan starts past that
+ * index. Every block before the earliest match is scanned in full by
+ * someone, so the result is the first occurrence, exactly as with
+ * std::find.
+ */
+
+// Elements handed to a worker at a time
+const std::size_t EASYFIND_PARALLEL_BLOCK = 1 << 18;
+
+// Elements scanned between checks of the shared earliest match
+const std::size_t EASYFIND_PARALLEL_SLICE = 1 << 14;
+
+// Below this many elements a single thread is faster than starting workers
+const std::size_t EASYFIND_PARALLEL_MIN = 1 << 20;
+
+namespace easyfind_detail {
+
+template<typename Iterator, typename Key>
+void parallelWorker(Iterator first, std::size_t count, Key value,
+                    std::atomic<std::size_t>& nextBlock, std::atomic<std::size_t>& best)
+{
+    for (;;) {
+        std::size_t begin = nextBlock.fetch_add(EASYFIND_PARALLEL_BLOCK, std::memory_order_relaxed);
+        if (begin >= count || begin >= best.load(std::memory_order_relaxed))
+            return;
+        std::size_t end = begin + EASYFIND_PARALLEL_BLOCK < count ? begin + EASYFIND_PARALLEL_BLOCK : count;
+
+        for (std::size_t slice = begin; slice < end; slice += EASYFIND_PARALLEL_SLICE) {
+            // Anything from here on is later than a match already found
+            if (slice >= best.load(std::memory_order_relaxed))
+                return;
+            std::size_t sliceEnd = slice + EASYFIND_PARALLEL_SLICE < end ? slice + EASYFIND_PARALLEL_SLICE : end;
+            Iterator hit = easyfindRange(first + slice, first + sliceEnd, value);
+            if (hit != first + sliceEnd) {
+                std::size_t found = static_cast<std::size_t>(hit - first);
+                std::size_t current = best.load(std::memory_order_relaxed);
+                while (found < current && !best.compare_exchange_weak(current, found, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    }
+}
+
+// easyfindParallelRange once the value has been converted to a key
+template<typename Iterator, typename Key>
+Iterator parallelSearch(Iterator first, Iterator last, const Key& value, unsigned int threads)
+{
+    std::size_t count = static_cast<std::size_t>(last - first);
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    std::size_t blocks = (count + EASYFIND_PARALLEL_BLOCK - 1) / EASYFIND_PARALLEL_BLOCK;
+    if (threads > blocks)
+        threads = static_cast<unsigned int>(blocks);
+    if (threads <= 1 || count < EASYFIND_PARALLEL_MIN)
+        return easyfindRange(first, last, value);
+
+    std::atomic<std::size_t> nextBlock(0);
+    std::atomic<std::size_t> best(count);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.push_back(std::thread(parallelWorker<Iterator, Key>, first, count, value,
+                                      std::ref(nextBlock), std::ref(best)));
+    }
+    parallelWorker(first, count, value, nextBlock, best);
+    for (std::size_t t = 0; t < workers.size(); ++t)
+        workers[t].join();
+
+    return first + best.load(std::memory_order_relaxed);
+}
+
+} // namespace easyfind_detail
+
+/**
+ * First occurrence of value in [first, last), searched by several threads
+ * An integer value the element type cannot represent is reported as not
+ * found without starting any workers, as in easyfindRange.
+ * @param first, last A random-access range
+ * @param value The value to find (any type comparable with the elements)
+ * @param threads Worker count including the caller; 0 means one per core
+ * @return Iterator to the first occurrence of the value, or last
+ */
+template<typename Iterator, typename V>
+Iterator easyfindParallelRange(Iterator first, Iterator last, const V& value, unsigned int threads = 0)
+{
+    static_assert(std::random_access_iterator<Iterator>,
+                  "easyfindParallel needs a random-access container");
+
+    typedef std::iter_value_t<Iterator> Element;
+
+    if constexpr (std::is_integral_v<Element> && std::is_integral_v<V>) {
+        Element key;
+        if (!easyfind_detail::fitsIn(value, key))
+            return last;
+        return easyfind_detail::parallelSearch(first, last, key, threads);
+    } else {
+        return easyfind_detail::parallelSearch(first, last, value, threads);
+    }
+}
+
+/**
+ * Parallel easyfind
+ * @param container The random-access container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @param threads Worker count including the caller; 0 means one per core
+ * @return Iterator to the first occurrence of the value
+ * @throws std::runtime_error if the value is not found
+ */
+template<typename T, typename V>
+typename T::iterator easyfindParallel(T& container, const V& value, unsigned int threads = 0)
+{
+    typename T::iterator it = easyfindParallelRange(container.begin(), container.end(), value, threads);
+
+    if (it == container.end())
+        throw std::runtime_error("Value not found in container");
+
+    return it;
+}
+
+/**
+ * Const version of easyfindParallel for const containers
+ * @param container The const random-access container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @param threads Worker count including the caller; 0 means one per core
+ * @return Const iterator to the first occurrence of the value
+ * @throws std::runtime_error if the value is not found
+ */
+template<typename T, typename V>
+typename T::const_iterator easyfindParallel(const T& container, const V& value, unsigned int threads = 0)
+{
+    typename T::const_iterator it = easyfindParallelRange(container.begin(), container.end(), value, threads);
+
+    if (it == container.end())
+        throw std::runtime_error("Value not found in container");
+
+    return it;
+}
+
+/**
+ * Non-throwing parallel easyfind
+ * @param container The random-access container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @param threads Worker count including the caller; 0 means one per core
+ * @return Iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::iterator easyfindParallel(T& container, const V& value, const std::nothrow_t&, unsigned int threads = 0)
+{
+    return easyfindParallelRange(container.begin(), container.end(), value, threads);
+}
+
+/**
+ * Non-throwing parallel easyfind for const containers
+ * @param container The const random-access container to search in (type T)
+ * @param value The value to find (any type comparable with the elements)
+ * @param threads Worker count including the caller; 0 means one per core
+ * @return Const iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::const_iterator easyfindParallel(const T& container, const V& value, const std::nothrow_t&, unsigned int threads = 0)
+{
+    return easyfindParallelRange(container.begin(), container.end(), value, threads);
+}
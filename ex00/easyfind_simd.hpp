@@ -0,0 +1,374 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define EASYFIND_X86 1
+# include <immintrin.h>
+#endif
+
+/**
+ * Vectorised linear search used by easyfind on contiguous integer storage.
+ *
+ * Byte-sized elements go through memchr. 16-, 32- and 64-bit integers have
+ * a portable scalar kernel and, on x86, SSE2 (one 16-byte compare) and AVX2
+ * (one 32-byte compare) kernels, so 8 to 32 elements are compared at once
+ * depending on their width. The same compares also produce 64-element match
+ * bitmasks for easyfindAll. The widest instruction set supported by the
+ * running CPU is picked on first use.
+ */
+enum EasyfindIsa {
+    EASYFIND_ISA_SCALAR,
+    EASYFIND_ISA_SSE2,
+    EASYFIND_ISA_AVX2
+};
+
+namespace easyfind_detail {
+
+// Element types with a vectorised search: integers other than bool
+template<typename E>
+inline constexpr bool hasFastSearch = std::is_integral_v<E> && !std::is_same_v<E, bool>
+                                   && (sizeof(E) == 1 || sizeof(E) == 2 || sizeof(E) == 4 || sizeof(E) == 8);
+
+template<typename E>
+inline std::size_t findScalar(const E* data, std::size_t count, E value)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        if (data[i] == value)
+            return i;
+    }
+    return count;
+}
+
+#ifdef EASYFIND_X86
+
+// Lane-wise equality; a lane is all ones where the elements are equal
+template<typename E>
+__attribute__((target("sse2")))
+inline __m128i equal128(__m128i a, __m128i b)
+{
+    if constexpr (sizeof(E) == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (sizeof(E) == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else if constexpr (sizeof(E) == 4) {
+        return _mm_cmpeq_epi32(a, b);
+    } else {
+        // SSE2 has no 64-bit compare: both 32-bit halves must match
+        __m128i halves = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(halves, _mm_shuffle_epi32(halves, 0xB1));
+    }
+}
+
+template<typename E>
+__attribute__((target("sse2")))
+inline __m128i broadcast128(E value)
+{
+    if constexpr (sizeof(E) == 1)
+        return _mm_set1_epi8(static_cast<char>(value));
+    else if constexpr (sizeof(E) == 2)
+        return _mm_set1_epi16(static_cast<short>(value));
+    else if constexpr (sizeof(E) == 4)
+        return _mm_set1_epi32(static_cast<int>(value));
+    else
+        return _mm_set1_epi64x(static_cast<long long>(value));
+}
+
+// SSE2 kernel: four 16-byte compares per iteration, one branch per iteration
+template<typename E>
+__attribute__((target("sse2")))
+inline std::size_t findSse2(const E* data, std::size_t count, E value)
+{
+    const std::size_t lanes = 16 / sizeof(E);
+    const __m128i needle = broadcast128(value);
+    std::size_t i = 0;
+
+    for (; i + 4 * lanes <= count; i += 4 * lanes) {
+        __m128i eq0 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+        __m128i eq1 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lanes)), needle);
+        __m128i eq2 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2 * lanes)), needle);
+        __m128i eq3 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 3 * lanes)), needle);
+        __m128i any = _mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3));
+        if (_mm_movemask_epi8(any) != 0) {
+            // One bit per byte across the four vectors; the lowest set bit
+            // belongs to the first matching element
+            unsigned long long mask = static_cast<unsigned long long>(_mm_movemask_epi8(eq0))
+                                    | static_cast<unsigned long long>(_mm_movemask_epi8(eq1)) << 16
+                                    | static_cast<unsigned long long>(_mm_movemask_epi8(eq2)) << 32
+                                    | static_cast<unsigned long long>(_mm_movemask_epi8(eq3)) << 48;
+            return i + __builtin_ctzll(mask) / sizeof(E);
+        }
+    }
+    for (; i + lanes <= count; i += lanes) {
+        __m128i eq = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+        int mask = _mm_movemask_epi8(eq);
+        if (mask != 0)
+            return i + __builtin_ctz(mask) / sizeof(E);
+    }
+    return i + findScalar(data + i, count - i, value);
+}
+
+template<typename E>
+__attribute__((target("avx2")))
+inline __m256i equal256(__m256i a, __m256i b)
+{
+    if constexpr (sizeof(E) == 1)
+        return _mm256_cmpeq_epi8(a, b);
+    else if constexpr (sizeof(E) == 2)
+        return _mm256_cmpeq_epi16(a, b);
+    else if constexpr (sizeof(E) == 4)
+        return _mm256_cmpeq_epi32(a, b);
+    else
+        return _mm256_cmpeq_epi64(a, b);
+}
+
+template<typename E>
+__attribute__((target("avx2")))
+inline __m256i broadcast256(E value)
+{
+    if constexpr (sizeof(E) == 1)
+        return _mm256_set1_epi8(static_cast<char>(value));
+    else if constexpr (sizeof(E) == 2)
+        return _mm256_set1_epi16(static_cast<short>(value));
+    else if constexpr (sizeof(E) == 4)
+        return _mm256_set1_epi32(static_cast<int>(value));
+    else
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+}
+
+// Position of the first matching element in a 32-byte compare result
+template<typename E>
+__attribute__((target("avx2")))
+inline std::size_t firstLane256(__m256i eq)
+{
+    return __builtin_ctz(static_cast<unsigned int>(_mm256_movemask_epi8(eq))) / sizeof(E);
+}
+
+// AVX2 kernel: four 32-byte compares per iteration, one branch per iteration
+template<typename E>
+__attribute__((target("avx2")))
+inline std::size_t findAvx2(const E* data, std::size_t count, E value)
+{
+    const std::size_t lanes = 32 / sizeof(E);
+    const __m256i needle = broadcast256(value);
+    std::size_t i = 0;
+
+    for (; i + 4 * lanes <= count; i += 4 * lanes) {
+        __m256i eq0 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+        __m256i eq1 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + lanes)), needle);
+        __m256i eq2 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 2 * lanes)), needle);
+        __m256i eq3 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 3 * lanes)), needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if (!_mm256_testz_si256(any, any)) {
+            if (!_mm256_testz_si256(eq0, eq0))
+                return i + firstLane256<E>(eq0);
+            if (!_mm256_testz_si256(eq1, eq1))
+                return i + lanes + firstLane256<E>(eq1);
+            if (!_mm256_testz_si256(eq2, eq2))
+                return i + 2 * lanes + firstLane256<E>(eq2);
+            return i + 3 * lanes + firstLane256<E>(eq3);
+        }
+    }
+    for (; i + lanes <= count; i += lanes) {
+        __m256i eq = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+        if (!_mm256_testz_si256(eq, eq))
+            return i + firstLane256<E>(eq);
+    }
+    return i + findSse2(data + i, count - i, value);
+}
+
+// Match bitmasks: bit i is set when data[i] == value, for one block of
+// EASYFIND_MASK_BLOCK elements
+
+template<typename E>
+__attribute__((target("sse2")))
+inline std::uint64_t matchMaskSse2(const E* data, E value)
+{
+    const std::size_t lanes = 16 / sizeof(E);
+    const __m128i needle = broadcast128(value);
+    std::uint64_t mask = 0;
+
+    if constexpr (sizeof(E) == 2) {
+        // Pack two vectors of 16-bit results into one of bytes
+        for (std::size_t i = 0; i < 64; i += 2 * lanes) {
+            __m128i eq0 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+            __m128i eq1 = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + lanes)), needle);
+            std::uint64_t bits = static_cast<unsigned int>(_mm_movemask_epi8(_mm_packs_epi16(eq0, eq1)));
+            mask |= bits << i;
+        }
+    } else {
+        for (std::size_t i = 0; i < 64; i += lanes) {
+            __m128i eq = equal128<E>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+            std::uint64_t bits;
+            if constexpr (sizeof(E) == 1)
+                bits = static_cast<unsigned int>(_mm_movemask_epi8(eq));
+            else if constexpr (sizeof(E) == 4)
+                bits = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+            else
+                bits = static_cast<unsigned int>(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+            mask |= bits << i;
+        }
+    }
+    return mask;
+}
+
+template<typename E>
+__attribute__((target("avx2")))
+inline std::uint64_t matchMaskAvx2(const E* data, E value)
+{
+    const std::size_t lanes = 32 / sizeof(E);
+    const __m256i needle = broadcast256(value);
+    std::uint64_t mask = 0;
+
+    if constexpr (sizeof(E) == 2) {
+        // packs works per 128-bit half; the permute restores element order
+        for (std::size_t i = 0; i < 64; i += 2 * lanes) {
+            __m256i eq0 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+            __m256i eq1 = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + lanes)), needle);
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(eq0, eq1), 0xD8);
+            std::uint64_t bits = static_cast<unsigned int>(_mm256_movemask_epi8(packed));
+            mask |= bits << i;
+        }
+    } else {
+        for (std::size_t i = 0; i < 64; i += lanes) {
+            __m256i eq = equal256<E>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+            std::uint64_t bits;
+            if constexpr (sizeof(E) == 1)
+                bits = static_cast<unsigned int>(_mm256_movemask_epi8(eq));
+            else if constexpr (sizeof(E) == 4)
+                bits = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+            else
+                bits = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+            mask |= bits << i;
+        }
+    }
+    return mask;
+}
+
+#endif
+
+inline EasyfindIsa bestIsa()
+{
+#ifdef EASYFIND_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return EASYFIND_ISA_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return EASYFIND_ISA_SSE2;
+#endif
+    return EASYFIND_ISA_SCALAR;
+}
+
+// -1 until the first search resolves it
+inline std::atomic<int> g_isa(-1);
+
+inline EasyfindIsa currentIsa()
+{
+    int isa = g_isa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = bestIsa();
+        g_isa.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<EasyfindIsa>(isa);
+}
+
+} // namespace easyfind_detail
+
+/**
+ * Index of the first occurrence of value in a contiguous integer range
+ * @param data Pointer to the first element
+ * @param count Number of elements
+ * @param value The value to find
+ * @return Index of the first match, or count if there is none
+ */
+template<typename E>
+inline std::size_t easyfindOffset(const E* data, std::size_t count, E value)
+{
+    static_assert(easyfind_detail::hasFastSearch<E>, "easyfindOffset needs an integer element type");
+
+    if constexpr (sizeof(E) == 1) {
+        if (count == 0)
+            return 0;
+        const void* hit = std::memchr(data, static_cast<unsigned char>(value), count);
+        return hit == NULL ? count : static_cast<std::size_t>(static_cast<const E*>(hit) - data);
+    } else {
+#ifdef EASYFIND_X86
+        switch (easyfind_detail::currentIsa()) {
+            case EASYFIND_ISA_AVX2:
+                return easyfind_detail::findAvx2(data, count, value);
+            case EASYFIND_ISA_SSE2:
+                return easyfind_detail::findSse2(data, count, value);
+            default:
+                break;
+        }
+#endif
+        return easyfind_detail::findScalar(data, count, value);
+    }
+}
+
+// Elements covered by one easyfindMatchMask call
+const std::size_t EASYFIND_MASK_BLOCK = 64;
+
+/**
+ * Bitmask of the elements equal to value in a contiguous integer block
+ * @param data Pointer to the first element
+ * @param count Number of elements, at most EASYFIND_MASK_BLOCK
+ * @param value The value to match
+ * @return Bit i set when data[i] == value
+ */
+template<typename E>
+inline std::uint64_t easyfindMatchMask(const E* data, std::size_t count, E value)
+{
+    static_assert(easyfind_detail::hasFastSearch<E>, "easyfindMatchMask needs an integer element type");
+
+#ifdef EASYFIND_X86
+    if (count == EASYFIND_MASK_BLOCK) {
+        switch (easyfind_detail::currentIsa()) {
+            case EASYFIND_ISA_AVX2:
+                return easyfind_detail::matchMaskAvx2(data, value);
+            case EASYFIND_ISA_SSE2:
+                return easyfind_detail::matchMaskSse2(data, value);
+            default:
+                break;
+        }
+    }
+#endif
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < count; ++i)
+        mask |= static_cast<std::uint64_t>(data[i] == value) << i;
+    return mask;
+}
+
+// Instruction set currently used by easyfind
+inline EasyfindIsa easyfindIsa()
+{
+    return easyfind_detail::currentIsa();
+}
+
+// Best instruction set supported by this CPU
+inline EasyfindIsa easyfindBestIsa()
+{
+    return easyfind_detail::bestIsa();
+}
+
+// Restrict easyfind to an instruction set (clamped to what the CPU supports)
+inline void setEasyfindIsa(EasyfindIsa isa)
+{
+    EasyfindIsa best = easyfind_detail::bestIsa();
+    easyfind_detail::g_isa.store(isa > best ? best : isa, std::memory_order_relaxed);
+}
+
+inline const char* easyfindIsaName(EasyfindIsa isa)
+{
+    switch (isa) {
+        case EASYFIND_ISA_AVX2:
+            return "AVX2";
+        case EASYFIND_ISA_SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+    }
+}
@@ -0,0 +1,245 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include "easyfind.hpp"
+
+/**
+ * Opt-in search for containers the caller keeps sorted in ascending order.
+ * Only random-access ranges qualify. The result is the same as easyfind's:
+ * the first of any equal elements.
+ *
+ * - BINARY:        branchless lower bound, O(log n); the loop compiles to
+ *                  conditional moves, so there are no mispredicted branches
+ * - INTERPOLATION: probes where the value should sit if the elements were
+ *                  spread evenly, O(log log n) on uniform data; after a few
+ *                  probes, or as soon as a probe fails to cut the range to a
+ *                  quarter, it hands the rest to BINARY, so skewed data
+ *                  costs little more than O(log n)
+ * - AUTO:          INTERPOLATION when three sample points lie close to the
+ *                  straight line between the first and last element,
+ *                  BINARY otherwise
+ */
+enum EasyfindSearch {
+    EASYFIND_SEARCH_AUTO,
+    EASYFIND_SEARCH_BINARY,
+    EASYFIND_SEARCH_INTERPOLATION
+};
+
+// Interpolation probes before the rest of the range goes to binary search
+const unsigned int EASYFIND_INTERPOLATION_PROBES = 4;
+
+// Distance of the bracketing probe from the interpolated position
+const std::size_t EASYFIND_INTERPOLATION_GAP = 8;
+
+// Ranges shorter than this go straight to binary search
+const std::size_t EASYFIND_INTERPOLATION_MIN = 64;
+
+namespace easyfind_detail {
+
+// Index of the first element in [lo, hi) not less than value
+template<typename Iterator, typename Key>
+std::size_t branchlessLowerBound(Iterator first, std::size_t lo, std::size_t hi, const Key& value)
+{
+    std::size_t count = hi - lo;
+    if (count == 0)
+        return lo;
+    while (count > 1) {
+        std::size_t half = count / 2;
+        lo = first[lo + half] < value ? lo + half : lo;
+        count -= half;
+    }
+    return lo + (first[lo] < value);
+}
+
+template<typename Iterator, typename Key>
+std::size_t interpolationLowerBound(Iterator first, std::size_t count, const Key& value)
+{
+    // Everything before lo is < value, everything from hi on is >= value
+    std::size_t lo = 0;
+    std::size_t hi = count;
+    for (unsigned int probe = 0; probe < EASYFIND_INTERPOLATION_PROBES && hi - lo > 16; ++probe) {
+        // Compare on the element type: 64-bit keys do not survive the
+        // round trip through double, so double only estimates the position
+        if (!(first[lo] < value))
+            return lo;
+        if (first[hi - 1] < value)
+            return hi;
+
+        // first[lo] < value <= first[hi - 1]; rounding to double keeps that
+        // order (possibly as equality), so the estimate lands in [lo, hi - 1]
+        double low = static_cast<double>(first[lo]);
+        double high = static_cast<double>(first[hi - 1]);
+        if (!(high > low))
+            break;  // The endpoints round to the same double: no estimate
+        double fraction = (static_cast<double>(value) - low) / (high - low);
+        std::size_t pos = lo + static_cast<std::size_t>(fraction * static_cast<double>(hi - 1 - lo));
+        if (pos > hi - 1)
+            pos = hi - 1;
+        // The estimate bounds one side; a second probe a few elements away
+        // (usually in the same cache line) bounds the other
+        std::size_t before = hi - lo;
+        if (first[pos] < value) {
+            lo = pos + 1;
+            std::size_t next = pos + EASYFIND_INTERPOLATION_GAP < hi - 1 ? pos + EASYFIND_INTERPOLATION_GAP : hi - 1;
+            if (first[next] < value)
+                lo = next + 1;
+            else
+                hi = next;
+        } else {
+            hi = pos;
+            std::size_t next = pos >= lo + EASYFIND_INTERPOLATION_GAP ? pos - EASYFIND_INTERPOLATION_GAP : lo;
+            if (first[next] < value)
+                lo = next + 1;
+            else
+                hi = next;
+        }
+        // A probe that did not cut the range to a quarter means the data is
+        // not spread evenly here; binary search does better from now on
+        if ((hi - lo) * 4 > before)
+            break;
+    }
+    return branchlessLowerBound(first, lo, hi, value);
+}
+
+// Whether the quartiles sit within 1/8 of the value range from where an
+// even spread would put them
+template<typename Iterator>
+bool looksUniform(Iterator first, std::size_t count)
+{
+    double low = static_cast<double>(first[0]);
+    double high = static_cast<double>(first[count - 1]);
+    double tolerance = (high - low) / 8;
+    if (tolerance <= 0)
+        return false;
+    for (std::size_t quarter = 1; quarter <= 3; ++quarter) {
+        std::size_t index = count * quarter / 4;
+        double expected = low + (high - low) * static_cast<double>(index) / static_cast<double>(count - 1);
+        double actual = static_cast<double>(first[index]);
+        if (actual - expected > tolerance || expected - actual > tolerance)
+            return false;
+    }
+    return true;
+}
+
+// easyfindSortedRange once the value has been converted to a key
+template<typename Iterator, typename Key>
+Iterator sortedSearch(Iterator first, Iterator last, const Key& value, EasyfindSearch method)
+{
+    std::size_t count = static_cast<std::size_t>(last - first);
+    std::size_t index;
+    if constexpr (std::is_arithmetic_v<std::iter_value_t<Iterator> > && std::is_arithmetic_v<Key>) {
+        if (method == EASYFIND_SEARCH_AUTO)
+            method = count >= EASYFIND_INTERPOLATION_MIN && easyfind_detail::looksUniform(first, count)
+                   ? EASYFIND_SEARCH_INTERPOLATION : EASYFIND_SEARCH_BINARY;
+        if (method == EASYFIND_SEARCH_INTERPOLATION)
+            index = easyfind_detail::interpolationLowerBound(first, count, value);
+        else
+            index = easyfind_detail::branchlessLowerBound(first, 0, count, value);
+    } else {
+        // Interpolation needs element distances; only ordering is available
+        index = easyfind_detail::branchlessLowerBound(first, 0, count, value);
+    }
+
+    if (index < count && first[index] == value)
+        return first + index;
+    return last;
+}
+
+} // namespace easyfind_detail
+
+/**
+ * First occurrence of value in the sorted range [first, last)
+ * An integer value the element type cannot represent is reported as not
+ * found without searching, as in easyfindRange.
+ * @param first, last A random-access range in ascending order
+ * @param value The value to find (any type ordered against the elements)
+ * @param method Which search to run
+ * @return Iterator to the first occurrence of the value, or last
+ */
+template<typename Iterator, typename V>
+Iterator easyfindSortedRange(Iterator first, Iterator last, const V& value,
+                             EasyfindSearch method = EASYFIND_SEARCH_AUTO)
+{
+    static_assert(std::random_access_iterator<Iterator>,
+                  "easyfindSorted needs a random-access container");
+
+    typedef std::iter_value_t<Iterator> Element;
+
+    if constexpr (std::is_integral_v<Element> && std::is_integral_v<V>) {
+        Element key;
+        if (!easyfind_detail::fitsIn(value, key))
+            return last;
+        return easyfind_detail::sortedSearch(first, last, key, method);
+    } else {
+        return easyfind_detail::sortedSearch(first, last, value, method);
+    }
+}
+
+/**
+ * easyfind for containers kept in ascending order
+ * @param container The sorted random-access container to search in (type T)
+ * @param value The value to find (any type ordered against the elements)
+ * @param method Which search to run
+ * @return Iterator to the first occurrence of the value
+ * @throws std::runtime_error if the value is not found
+ */
+template<typename T, typename V>
+typename T::iterator easyfindSorted(T& container, const V& value, EasyfindSearch method = EASYFIND_SEARCH_AUTO)
+{
+    typename T::iterator it = easyfindSortedRange(container.begin(), container.end(), value, method);
+
+    if (it == container.end())
+        throw std::runtime_error("Value not found in container");
+
+    return it;
+}
+
+/**
+ * Const version of easyfindSorted for const containers
+ * @param container The const sorted random-access container to search in (type T)
+ * @param value The value to find (any type ordered against the elements)
+ * @param method Which search to run
+ * @return Const iterator to the first occurrence of the value
+ * @throws std::runtime_error if the value is not found
+ */
+template<typename T, typename V>
+typename T::const_iterator easyfindSorted(const T& container, const V& value, EasyfindSearch method = EASYFIND_SEARCH_AUTO)
+{
+    typename T::const_iterator it = easyfindSortedRange(container.begin(), container.end(), value, method);
+
+    if (it == container.end())
+        throw std::runtime_error("Value not found in container");
+
+    return it;
+}
+
+/**
+ * Non-throwing easyfindSorted
+ * @param container The sorted random-access container to search in (type T)
+ * @param value The value to find (any type ordered against the elements)
+ * @param method Which search to run
+ * @return Iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::iterator easyfindSorted(T& container, const V& value, const std::nothrow_t&,
+                                    EasyfindSearch method = EASYFIND_SEARCH_AUTO)
+{
+    return easyfindSortedRange(container.begin(), container.end(), value, method);
+}
+
+/**
+ * Non-throwing easyfindSorted for const containers
+ * @param container The const sorted random-access container to search in (type T)
+ * @param value The value to find (any type ordered against the elements)
+ * @param method Which search to run
+ * @return Const iterator to the first occurrence of the value, or container.end()
+ */
+template<typename T, typename V>
+typename T::const_iterator easyfindSorted(const T& container, const V& value, const std::nothrow_t&,
+                                          EasyfindSearch method = EASYFIND_SEARCH_AUTO)
+{
+    return easyfindSortedRange(container.begin(), container.end(), value, method);
+}
@@ -1,9 +1,19 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <string>
 #include <deque>
+#include <array>
+#include <set>
+#include <unordered_set>
 #include <exception>
+#include <limits>
 #include "easyfind.hpp"
+#include "easyfind_batch.hpp"
+#include "easyfind_sorted.hpp"
+#include "easyfind_index.hpp"
+#include "easyfind_parallel.hpp"
+#include "easyfind_all.hpp"
 
 template<typename T>
 void testContainer(T& container, const std::string& containerName, int searchValue)
@@ -51,6 +61,633 @@ void testConstContainer(const T& container, const std::string& containerName, in
     }
 }
 
+// Compare the vectorised search with std::find for every length and match
+// position around the vector widths, on each instruction set the CPU has
+void testSimdSearch()
+{
+    std::cout << "\n--- Testing SIMD search ---" << std::endl;
+
+    EasyfindIsa best = easyfindBestIsa();
+    for (int isa = EASYFIND_ISA_SCALAR; isa <= best; ++isa) {
+        setEasyfindIsa(static_cast<EasyfindIsa>(isa));
+        bool ok = true;
+        for (int length = 0; length <= 100 && ok; ++length) {
+            std::vector<int> values;
+            for (int i = 0; i < length; ++i)
+                values.push_back(i * 2);
+            // Every present value, plus misses in the gaps and past the end
+            for (int value = -1; value <= length * 2 && ok; ++value) {
+                std::vector<int>::iterator expected = std::find(values.begin(), values.end(), value);
+                ok = easyfindRange(values.begin(), values.end(), value) == expected;
+            }
+        }
+        std::cout << (ok ? "✓ " : "✗ ") << easyfindIsaName(static_cast<EasyfindIsa>(isa))
+                  << " search matches std::find" << std::endl;
+    }
+    setEasyfindIsa(best);
+
+    // Duplicates inside one vector block: the first lane must win
+    std::vector<int> dup(64, 0);
+    dup[37] = 9;
+    dup[38] = 9;
+    dup[45] = 9;
+    std::vector<int>::iterator it = easyfind(dup, 9);
+    std::cout << (it - dup.begin() == 37 ? "✓ " : "✗ ")
+              << "First of several matches found at position " << (it - dup.begin()) << std::endl;
+
+    // std::array is contiguous too
+    std::array<int, 20> arr;
+    for (int i = 0; i < 20; ++i)
+        arr[i] = 100 + i;
+    std::array<int, 20>::iterator found = easyfind(arr, 117);
+    std::cout << (*found == 117 ? "✓ " : "✗ ") << "Found value " << *found << " in std::array" << std::endl;
+
+    // A million-entry ID vector, hit at the very end
+    std::vector<int> ids(1000000);
+    for (size_t i = 0; i < ids.size(); ++i)
+        ids[i] = static_cast<int>(i * 7);
+    const std::vector<int>& constIds = ids;
+    std::vector<int>::const_iterator last = easyfind(constIds, 999999 * 7);
+    std::cout << (last - constIds.begin() == 999999 ? "✓ " : "✗ ")
+              << "Found last of 1000000 IDs using " << easyfindIsaName(easyfindIsa()) << std::endl;
+}
+
+// Non-throwing lookups report a miss as end() for every container kind
+template<typename T>
+void testNothrowContainer(T& container, const std::string& containerName, int present, int missing)
+{
+    const T& constContainer = container;
+
+    typename T::iterator hit = easyfind(container, present, std::nothrow);
+    typename T::iterator miss = easyfind(container, missing, std::nothrow);
+    typename T::const_iterator constHit = easyfind(constContainer, present, std::nothrow);
+    typename T::const_iterator constMiss = easyfind(constContainer, missing, std::nothrow);
+
+    bool ok = hit != container.end() && *hit == present && miss == container.end()
+           && constHit != constContainer.end() && *constHit == present
+           && constMiss == constContainer.end();
+    std::cout << (ok ? "✓ " : "✗ ") << containerName
+              << ": hit returns the element, miss returns end()" << std::endl;
+}
+
+void testNothrowSearch()
+{
+    std::cout << "\n--- Testing nothrow easyfind ---" << std::endl;
+
+    std::vector<int> vec;
+    std::list<int> lst;
+    std::deque<int> deq;
+    for (int i = 0; i < 50; ++i) {
+        vec.push_back(i * 3);
+        lst.push_back(i * 3);
+        deq.push_back(i * 3);
+    }
+    testNothrowContainer(vec, "std::vector", 42, 43);
+    testNothrowContainer(lst, "std::list", 42, 43);
+    testNothrowContainer(deq, "std::deque", 42, 43);
+
+    std::vector<int> emptyVec;
+    std::cout << (easyfind(emptyVec, 1, std::nothrow) == emptyVec.end() ? "✓ " : "✗ ")
+              << "empty std::vector: miss returns end()" << std::endl;
+
+    // The throwing overload still throws on a miss
+    try {
+        easyfind(vec, 43);
+        std::cout << "✗ Throwing easyfind returned on a miss" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "✓ Throwing easyfind still throws: " << e.what() << std::endl;
+    }
+}
+
+// Every batch strategy must agree with one easyfind per query
+template<typename T>
+void testBatchContainer(const std::string& containerName)
+{
+    // Values 0..39 with duplicates; queries mix hits, repeats and misses
+    T container;
+    for (int i = 0; i < 200; ++i)
+        container.push_back((i * 37) % 40);
+    std::vector<int> queries;
+    for (int q = -5; q < 60; ++q)
+        queries.push_back(q % 45);
+
+    const char* names[] = {"auto", "scan", "hash", "merge"};
+    for (int strategy = EASYFIND_BATCH_AUTO; strategy <= EASYFIND_BATCH_MERGE; ++strategy) {
+        std::vector<typename T::iterator> results = easyfindBatch(container, queries.begin(), queries.end(),
+                                                                  static_cast<EasyfindBatchStrategy>(strategy));
+        bool ok = results.size() == queries.size();
+        for (size_t q = 0; ok && q < queries.size(); ++q)
+            ok = results[q] == easyfind(container, queries[q], std::nothrow);
+        std::cout << (ok ? "✓ " : "✗ ") << containerName << " batch (" << names[strategy]
+                  << ") matches per-query easyfind" << std::endl;
+    }
+
+    const T& constContainer = container;
+    std::list<int> listQueries(queries.begin(), queries.end());
+    std::vector<typename T::const_iterator> constResults = easyfindBatch(constContainer, listQueries.begin(), listQueries.end());
+    bool ok = constResults.front() == constContainer.end() && *constResults.back() == queries.back();
+    std::cout << (ok ? "✓ " : "✗ ") << "const " << containerName << " batch from a std::list of queries" << std::endl;
+}
+
+void testBatchSearch()
+{
+    std::cout << "\n--- Testing batch easyfind ---" << std::endl;
+    testBatchContainer<std::vector<int> >("std::vector");
+    testBatchContainer<std::list<int> >("std::list");
+    testBatchContainer<std::deque<int> >("std::deque");
+
+    // Elements outside the int range must not alias int queries
+    std::vector<long> wide;
+    wide.push_back(4294967296L + 7);
+    wide.push_back(7);
+    int query = 7;
+    std::vector<std::vector<long>::iterator> results = easyfindBatch(wide, &query, &query + 1, EASYFIND_BATCH_HASH);
+    std::cout << (results[0] - wide.begin() == 1 ? "✓ " : "✗ ")
+              << "Out-of-range element skipped by hash batch" << std::endl;
+
+    // Queries the element type cannot hold are misses, not truncated hits
+    std::vector<long long> sixtyFour;
+    sixtyFour.push_back(5);
+    sixtyFour.push_back(7);
+    sixtyFour.push_back(9);
+    std::vector<long long> wideQueries;
+    wideQueries.push_back((1LL << 32) + 5);
+    wideQueries.push_back(9);
+    std::vector<short> narrow(sixtyFour.begin(), sixtyFour.end());
+    bool ok = true;
+    for (int strategy = EASYFIND_BATCH_AUTO; strategy <= EASYFIND_BATCH_MERGE; ++strategy) {
+        std::vector<std::vector<long long>::iterator> hits = easyfindBatch(sixtyFour, wideQueries.begin(), wideQueries.end(),
+                                                                           static_cast<EasyfindBatchStrategy>(strategy));
+        std::vector<std::vector<short>::iterator> narrowHits = easyfindBatch(narrow, wideQueries.begin(), wideQueries.end(),
+                                                                             static_cast<EasyfindBatchStrategy>(strategy));
+        ok = ok && hits[0] == sixtyFour.end() && hits[1] - sixtyFour.begin() == 2
+                && narrowHits[0] == narrow.end() && narrowHits[1] - narrow.begin() == 2;
+    }
+    std::cout << (ok ? "✓ " : "✗ ") << "64-bit queries are not truncated by any batch strategy" << std::endl;
+
+    std::vector<int> emptyVec;
+    std::vector<std::vector<int>::iterator> none = easyfindBatch(emptyVec, &query, &query + 1);
+    std::cout << (none.size() == 1 && none[0] == emptyVec.end() ? "✓ " : "✗ ")
+              << "Batch on an empty container reports end()" << std::endl;
+}
+
+// Sets are searched with their own lower_bound / find, with the same
+// result as a linear scan
+template<typename T>
+void testSetContainer(const std::string& containerName)
+{
+    T container;
+    for (int i = 0; i < 100; ++i)
+        container.insert((i * 7) % 60);
+    const T& constContainer = container;
+
+    bool ok = true;
+    for (int value = -5; value < 70 && ok; ++value) {
+        typename T::iterator expected = std::find(container.begin(), container.end(), value);
+        ok = easyfind(container, value, std::nothrow) == expected
+          && easyfind(constContainer, value, std::nothrow) == typename T::const_iterator(expected);
+    }
+    std::cout << (ok ? "✓ " : "✗ ") << containerName << " member lookup matches std::find" << std::endl;
+}
+
+// Set key with no default constructor
+struct Label
+{
+    int id;
+
+    explicit Label(int labelId) : id(labelId) {}
+
+    bool operator<(const Label& other) const { return id < other.id; }
+    bool operator==(const Label& other) const { return id == other.id; }
+};
+
+void testSetSearch()
+{
+    std::cout << "\n--- Testing set dispatch ---" << std::endl;
+    testSetContainer<std::set<int> >("std::set");
+    testSetContainer<std::multiset<int> >("std::multiset");
+    testSetContainer<std::set<int, std::greater<int> > >("descending std::set");
+    testSetContainer<std::unordered_set<int> >("std::unordered_set");
+    testSetContainer<std::unordered_multiset<int> >("std::unordered_multiset");
+
+    std::set<Label> labels;
+    for (int i = 0; i < 10; ++i)
+        labels.insert(Label(i * 2));
+    std::cout << (easyfind(labels, Label(6))->id == 6 && easyfind(labels, Label(7), std::nothrow) == labels.end()
+                  ? "✓ " : "✗ ") << "std::set of a key with no default constructor" << std::endl;
+
+    std::set<int> st;
+    st.insert(5);
+    try {
+        easyfind(st, 6);
+        std::cout << "✗ Missing value in std::set did not throw" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "✓ Missing value in std::set throws: " << e.what() << std::endl;
+    }
+}
+
+// Sorted search must return the first of equal elements, like std::find
+template<typename T>
+bool sortedMatchesFind(T& container, int low, int high)
+{
+    for (int method = EASYFIND_SEARCH_AUTO; method <= EASYFIND_SEARCH_INTERPOLATION; ++method) {
+        for (int value = low; value <= high; ++value) {
+            typename T::iterator expected = std::find(container.begin(), container.end(), value);
+            if (easyfindSorted(container, value, std::nothrow, static_cast<EasyfindSearch>(method)) != expected)
+                return false;
+        }
+    }
+    return true;
+}
+
+void testSortedSearch()
+{
+    std::cout << "\n--- Testing sorted easyfind ---" << std::endl;
+
+    // Evenly spread values with runs of duplicates
+    std::vector<int> uniform;
+    for (int i = 0; i < 3000; ++i)
+        uniform.push_back(i / 3 * 5);
+    std::cout << (sortedMatchesFind(uniform, -3, 5000) ? "✓ " : "✗ ")
+              << "Uniform sorted std::vector matches std::find" << std::endl;
+
+    // Quadratic growth: interpolation estimates are far off
+    std::vector<int> skewed;
+    for (int i = 0; i < 2000; ++i)
+        skewed.push_back(i * i);
+    std::cout << (sortedMatchesFind(skewed, -1, 4000) && sortedMatchesFind(skewed, 3990000, 3996005) ? "✓ " : "✗ ")
+              << "Skewed sorted std::vector matches std::find" << std::endl;
+
+    // Extreme values: no overflow in the interpolation estimate
+    std::vector<int> extremes;
+    extremes.push_back(std::numeric_limits<int>::min());
+    for (int i = -100; i <= 100; ++i)
+        extremes.push_back(i);
+    extremes.push_back(std::numeric_limits<int>::max());
+    bool ok = sortedMatchesFind(extremes, -105, 105);
+    for (int method = EASYFIND_SEARCH_AUTO; method <= EASYFIND_SEARCH_INTERPOLATION; ++method) {
+        ok = ok && easyfindSorted(extremes, std::numeric_limits<int>::max(), std::nothrow,
+                                  static_cast<EasyfindSearch>(method)) == extremes.end() - 1;
+    }
+    std::cout << (ok ? "✓ " : "✗ ") << "INT_MIN/INT_MAX endpoints handled" << std::endl;
+
+    std::deque<int> deq(uniform.begin(), uniform.end());
+    std::cout << (sortedMatchesFind(deq, 0, 200) ? "✓ " : "✗ ")
+              << "Sorted std::deque matches std::find" << std::endl;
+
+    std::vector<int> emptyVec;
+    std::cout << (easyfindSorted(emptyVec, 1, std::nothrow) == emptyVec.end() ? "✓ " : "✗ ")
+              << "Sorted search on an empty std::vector returns end()" << std::endl;
+
+    // -1 must not match UINT_MAX through an implicit conversion
+    std::vector<unsigned int> unsignedSorted;
+    for (unsigned int i = 0; i < 100; ++i)
+        unsignedSorted.push_back(i * 3);
+    unsignedSorted.push_back(std::numeric_limits<unsigned int>::max());
+    ok = true;
+    for (int method = EASYFIND_SEARCH_AUTO; method <= EASYFIND_SEARCH_INTERPOLATION; ++method) {
+        EasyfindSearch search = static_cast<EasyfindSearch>(method);
+        ok = ok && easyfindSorted(unsignedSorted, -1, std::nothrow, search) == unsignedSorted.end()
+                && easyfindSorted(unsignedSorted, 297, std::nothrow, search) - unsignedSorted.begin() == 99;
+    }
+    std::cout << (ok ? "✓ " : "✗ ") << "Sorted search on unsigned elements does not match -1" << std::endl;
+
+    // 64-bit keys this close together round to the same double
+    std::vector<long long> wide;
+    std::vector<unsigned long long> wideUnsigned;
+    for (long long i = 0; i < 1000; ++i) {
+        wide.push_back((1LL << 60) + 3 * i);
+        wideUnsigned.push_back(std::numeric_limits<unsigned long long>::max() - 3 * static_cast<unsigned long long>(999 - i));
+    }
+    ok = true;
+    for (int method = EASYFIND_SEARCH_AUTO; method <= EASYFIND_SEARCH_INTERPOLATION; ++method) {
+        EasyfindSearch search = static_cast<EasyfindSearch>(method);
+        for (size_t i = 0; i < wide.size(); ++i) {
+            ok = ok && easyfindSorted(wide, wide[i], std::nothrow, search) - wide.begin() == static_cast<long>(i)
+                    && easyfindSorted(wide, wide[i] + 1, std::nothrow, search) == wide.end()
+                    && easyfindSorted(wideUnsigned, wideUnsigned[i], std::nothrow, search) - wideUnsigned.begin() == static_cast<long>(i)
+                    && easyfindSorted(wideUnsigned, wideUnsigned[i] - 1, std::nothrow, search) == wideUnsigned.end();
+        }
+    }
+    std::cout << (ok ? "✓ " : "✗ ") << "Sorted search finds every 64-bit key" << std::endl;
+
+    const std::vector<int>& constUniform = uniform;
+    try {
+        std::vector<int>::const_iterator it = easyfindSorted(constUniform, 2500);
+        std::cout << "✓ Found value " << *it << " at position " << (it - constUniform.begin())
+                  << " in const sorted std::vector" << std::endl;
+        easyfindSorted(constUniform, 2501);
+        std::cout << "✗ Missing value did not throw" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "✓ Missing value throws: " << e.what() << std::endl;
+    }
+}
+
+// Indexed lookups must agree with easyfind for every value, hit or miss
+template<typename T, typename Index>
+bool indexMatchesEasyfind(T& container, const Index& index, int low, int high)
+{
+    for (int value = low; value <= high; ++value) {
+        if (index.find(value, std::nothrow) != easyfind(container, value, std::nothrow))
+            return false;
+    }
+    return true;
+}
+
+void testIndexedSearch()
+{
+    std::cout << "\n--- Testing EasyfindIndex ---" << std::endl;
+
+    std::vector<int> vec;
+    for (int i = 0; i < 1000; ++i)
+        vec.push_back((i * 37) % 300);
+    EasyfindIndex<std::vector<int> > index(vec);
+    std::cout << (indexMatchesEasyfind(vec, index, -10, 310) ? "✓ " : "✗ ")
+              << "Index matches easyfind, first of duplicates included ("
+              << index.distinctValues() << " distinct values)" << std::endl;
+
+    // Positions survive reallocation
+    vec.reserve(vec.capacity() * 4);
+    std::cout << (indexMatchesEasyfind(vec, index, -10, 310) ? "✓ " : "✗ ")
+              << "Index still valid after the vector reallocated" << std::endl;
+
+    // Appending: new values are indexed, existing first occurrences are kept
+    vec.push_back(5000);
+    vec.push_back(7);
+    index.indexAppended();
+    std::cout << (indexMatchesEasyfind(vec, index, -10, 310) && *index.find(5000) == 5000 ? "✓ " : "✗ ")
+              << "indexAppended picks up new values only" << std::endl;
+
+    // Arbitrary change: invalidated index falls back to scanning until rebuilt
+    vec[0] = 4242;
+    index.invalidate();
+    bool ok = !index.valid() && index.position(4242) == 0 && indexMatchesEasyfind(vec, index, -10, 310);
+    index.rebuild();
+    ok = ok && index.valid() && index.position(4242) == 0 && indexMatchesEasyfind(vec, index, -10, 310);
+    std::cout << (ok ? "✓ " : "✗ ") << "invalidate() scans, rebuild() restores the index" << std::endl;
+
+    try {
+        index.find(-1);
+        std::cout << "✗ Missing value did not throw" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "✓ Missing value throws: " << e.what() << std::endl;
+    }
+
+    // Deques are random access too; const containers give const iterators
+    const std::deque<int> deq(vec.begin(), vec.end());
+    EasyfindIndex<const std::deque<int> > constIndex(deq);
+    std::deque<int>::const_iterator it = constIndex.find(7);
+    std::cout << (indexMatchesEasyfind(deq, constIndex, -10, 310) ? "✓ " : "✗ ")
+              << "const std::deque index, found 7 at position " << (it - deq.begin()) << std::endl;
+
+    std::vector<int> emptyVec;
+    EasyfindIndex<std::vector<int> > emptyIndex(emptyVec);
+    std::cout << (emptyIndex.find(1, std::nothrow) == emptyVec.end() ? "✓ " : "✗ ")
+              << "Index over an empty container reports end()" << std::endl;
+
+    // 64-bit keys that agree in their low 32 bits stay distinct
+    std::vector<long long> wide;
+    for (long long i = 0; i < 100; ++i)
+        wide.push_back((i << 32) | 5);
+    EasyfindIndex<std::vector<long long> > wideIndex(wide);
+    ok = wideIndex.distinctValues() == 100 && indexMatchesEasyfind(wide, wideIndex, -10, 310);
+    for (long long i = 0; i < 100; ++i)
+        ok = ok && wideIndex.position((i << 32) | 5) == static_cast<size_t>(i);
+    ok = ok && wideIndex.position(6) == wideIndex.npos && wideIndex.position(100LL << 32 | 5) == wideIndex.npos;
+    std::cout << (ok ? "✓ " : "✗ ") << "int64_t index keeps keys that differ above bit 31" << std::endl;
+
+    // Queries the element type cannot hold are misses, not truncated matches
+    std::vector<unsigned char> bytes(10, 44);
+    EasyfindIndex<std::vector<unsigned char> > byteIndex(bytes);
+    ok = byteIndex.position(44) == 0 && byteIndex.position(300) == byteIndex.npos
+      && byteIndex.position(-212) == byteIndex.npos;
+    std::cout << (ok ? "✓ " : "✗ ") << "uint8_t index misses out-of-range queries" << std::endl;
+}
+
+// The parallel search must return the earliest match whichever worker
+// finds a match first
+void testParallelSearch()
+{
+    std::cout << "\n--- Testing parallel easyfind ---" << std::endl;
+
+    const size_t size = 3 * EASYFIND_PARALLEL_MIN + 12345;
+    std::vector<int> vec(size, 0);
+    // Later blocks match first in wall-clock terms: the earliest match sits
+    // at the end of block 2, the others at the start of later blocks
+    size_t earliest = 3 * EASYFIND_PARALLEL_BLOCK - 1;
+    vec[earliest] = 7;
+    vec[5 * EASYFIND_PARALLEL_BLOCK] = 7;
+    vec[size - 1] = 7;
+    vec[size - 1 - EASYFIND_PARALLEL_BLOCK] = 9;
+
+    const unsigned int threadCounts[] = {0, 1, 2, 3, 8};
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); ++t) {
+        unsigned int threads = threadCounts[t];
+        bool ok = easyfindParallel(vec, 7, std::nothrow, threads) - vec.begin() == static_cast<long>(earliest)
+               && easyfindParallel(vec, 9, std::nothrow, threads) - vec.begin() == static_cast<long>(size - 1 - EASYFIND_PARALLEL_BLOCK)
+               && *easyfindParallel(vec, 0, threads) == 0
+               && easyfindParallel(vec, 42, std::nothrow, threads) == vec.end();
+        std::cout << (ok ? "✓ " : "✗ ") << "Parallel search with " << threads
+                  << (threads == 0 ? " (one per core)" : "") << " threads matches std::find" << std::endl;
+    }
+
+    const std::deque<int> deq(vec.begin(), vec.end());
+    std::deque<int>::const_iterator it = easyfindParallel(deq, 7, 4);
+    std::cout << (it - deq.begin() == static_cast<long>(earliest) ? "✓ " : "✗ ")
+              << "Parallel search on const std::deque finds position " << (it - deq.begin()) << std::endl;
+
+    std::vector<unsigned int> unsignedVec(EASYFIND_PARALLEL_MIN, 0);
+    unsignedVec.back() = std::numeric_limits<unsigned int>::max();
+    std::cout << (easyfindParallel(unsignedVec, -1, std::nothrow, 4) == unsignedVec.end() ? "✓ " : "✗ ")
+              << "Parallel search on unsigned elements does not match -1" << std::endl;
+
+    try {
+        easyfindParallel(vec, 42, 4);
+        std::cout << "✗ Missing value did not throw" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << "✓ Missing value throws: " << e.what() << std::endl;
+    }
+}
+
+// Vectorised search on one element width against std::find, on every
+// instruction set, for every length and match position around the widths
+template<typename E>
+E widthValue(int value)
+{
+    // 64-bit values also differ in their upper halves
+    if constexpr (sizeof(E) == 8)
+        return static_cast<E>(value) << 33 | static_cast<E>(value);
+    return static_cast<E>(value);
+}
+
+template<typename E>
+bool widthMatchesFind()
+{
+    bool ok = true;
+    EasyfindIsa best = easyfindBestIsa();
+    for (int isa = EASYFIND_ISA_SCALAR; isa <= best && ok; ++isa) {
+        setEasyfindIsa(static_cast<EasyfindIsa>(isa));
+        for (int length = 0; length <= 140 && ok; ++length) {
+            std::vector<E> values;
+            for (int i = 0; i < length; ++i)
+                values.push_back(widthValue<E>(i * 3 + 1));
+            for (int value = 0; value <= length * 3 + 1 && ok; ++value) {
+                E key = widthValue<E>(value);
+                ok = easyfind(values, key, std::nothrow) == std::find(values.begin(), values.end(), key);
+            }
+        }
+    }
+    setEasyfindIsa(best);
+    return ok;
+}
+
+void testValueTypes()
+{
+    std::cout << "\n--- Testing value types ---" << std::endl;
+
+    std::cout << (widthMatchesFind<unsigned char>() ? "✓ " : "✗ ") << "uint8_t search (memchr) matches std::find" << std::endl;
+    std::cout << (widthMatchesFind<short>() ? "✓ " : "✗ ") << "int16_t search matches std::find" << std::endl;
+    std::cout << (widthMatchesFind<unsigned int>() ? "✓ " : "✗ ") << "uint32_t search matches std::find" << std::endl;
+    std::cout << (widthMatchesFind<long long>() ? "✓ " : "✗ ") << "int64_t search matches std::find" << std::endl;
+
+    // 64-bit keys differing only in the upper half must not match
+    std::vector<long long> keys;
+    for (long long i = 0; i < 100; ++i)
+        keys.push_back((i << 32) | 5);
+    std::vector<long long>::iterator key = easyfind(keys, (77LL << 32) | 5);
+    std::cout << (key - keys.begin() == 77 ? "✓ " : "✗ ")
+              << "64-bit key found at position " << (key - keys.begin()) << std::endl;
+
+    // Integer values outside the element type are never found
+    std::vector<unsigned char> bytes(64, 44);
+    std::vector<unsigned int> words(64, 4294967295u);
+    bool ok = easyfind(bytes, 300, std::nothrow) == bytes.end()
+           && easyfind(words, -1, std::nothrow) == words.end()
+           && *easyfind(bytes, 44) == 44;
+    std::cout << (ok ? "✓ " : "✗ ") << "Out-of-range values are compared by value, not converted" << std::endl;
+
+    // Byte buffers
+    std::string text = "the quick brown fox jumps over the lazy dog";
+    std::vector<char> buffer(text.begin(), text.end());
+    std::vector<char>::iterator fox = easyfind(buffer, 'f');
+    std::cout << (fox - buffer.begin() == 16 ? "✓ " : "✗ ")
+              << "Found 'f' in a char buffer at position " << (fox - buffer.begin()) << std::endl;
+
+    // Floating point goes through the generic path
+    std::vector<float> floats;
+    for (int i = 0; i < 40; ++i)
+        floats.push_back(i * 0.5f);
+    const std::vector<float>& constFloats = floats;
+    std::vector<float>::const_iterator half = easyfind(constFloats, 7.5f);
+    std::cout << (half - constFloats.begin() == 15 ? "✓ " : "✗ ")
+              << "Found 7.5f in a float vector at position " << (half - constFloats.begin()) << std::endl;
+
+    std::list<long long> lst(keys.begin(), keys.end());
+    std::cout << (easyfind(lst, (3LL << 32) | 5, std::nothrow) != lst.end() ? "✓ " : "✗ ")
+              << "64-bit key found in std::list" << std::endl;
+}
+
+// easyfindAll must yield exactly the positions a manual restart loop finds
+template<typename T>
+bool allMatchesLoop(T& container, typename T::value_type value)
+{
+    std::vector<typename T::iterator> expected;
+    for (typename T::iterator it = container.begin(); it != container.end(); ++it) {
+        if (*it == value)
+            expected.push_back(it);
+    }
+    size_t i = 0;
+    for (typename T::iterator it : easyfindAll(container, value)) {
+        if (i >= expected.size() || it != expected[i])
+            return false;
+        ++i;
+    }
+    return i == expected.size();
+}
+
+template<typename E>
+bool allMatchesWidth()
+{
+    bool ok = true;
+    EasyfindIsa best = easyfindBestIsa();
+    for (int isa = EASYFIND_ISA_SCALAR; isa <= best && ok; ++isa) {
+        setEasyfindIsa(static_cast<EasyfindIsa>(isa));
+        for (int length = 0; length <= 200 && ok; length += 7) {
+            std::vector<E> values;
+            for (int i = 0; i < length; ++i)
+                values.push_back(static_cast<E>((i * 7) % 5));
+            for (int value = 0; value < 6 && ok; ++value)
+                ok = allMatchesLoop(values, static_cast<E>(value));
+        }
+    }
+    setEasyfindIsa(best);
+    return ok;
+}
+
+void testAllMatches()
+{
+    std::cout << "\n--- Testing easyfindAll / easyfindIf ---" << std::endl;
+
+    std::cout << (allMatchesWidth<char>() && allMatchesWidth<short>() && allMatchesWidth<int>()
+                  && allMatchesWidth<long long>() ? "✓ " : "✗ ")
+              << "Bitmask scan yields every match in order for 8/16/32/64-bit elements" << std::endl;
+
+    std::list<int> lst;
+    std::deque<int> deq;
+    for (int i = 0; i < 100; ++i) {
+        lst.push_back(i % 7);
+        deq.push_back(i % 7);
+    }
+    std::cout << (allMatchesLoop(lst, 3) && allMatchesLoop(deq, 3) && allMatchesLoop(lst, 9) ? "✓ " : "✗ ")
+              << "std::list and std::deque yield every match in order" << std::endl;
+
+    // Every element matching: one mask block is all ones
+    std::vector<int> same(130, 4);
+    const std::vector<int>& constSame = same;
+    std::cout << (easyfindAll(constSame, 4).count() == 130 && easyfindAll(same, 5).empty() ? "✓ " : "✗ ")
+              << "130 of 130 matches counted, 0 for an absent value" << std::endl;
+
+    // Lazy: stop after the first few matches without scanning further
+    std::vector<int> vec;
+    for (int i = 0; i < 1000; ++i)
+        vec.push_back(i % 10);
+    EasyfindMatches<std::vector<int>::iterator, int> zeros = easyfindAll(vec, 0);
+    EasyfindMatches<std::vector<int>::iterator, int>::iterator it = zeros.begin();
+    ++it;
+    ++it;
+    std::cout << (*it - vec.begin() == 20 ? "✓ " : "✗ ") << "Third zero found at position "
+              << (*it - vec.begin()) << std::endl;
+
+    // Predicates
+    size_t evens = 0;
+    bool ok = true;
+    for (std::list<int>::iterator even : easyfindIf(lst, [](int value) { return value % 2 == 0; })) {
+        ok = ok && *even % 2 == 0;
+        ++evens;
+    }
+    size_t expected = static_cast<size_t>(std::count_if(lst.begin(), lst.end(), [](int value) { return value % 2 == 0; }));
+    std::cout << (ok && evens == expected ? "✓ " : "✗ ") << "easyfindIf yields the " << evens
+              << " even elements of a std::list" << std::endl;
+
+    std::cout << (easyfindIf(constSame, [](int value) { return value > 4; }).empty() ? "✓ " : "✗ ")
+              << "easyfindIf with no match is empty" << std::endl;
+
+    // The iterator keeps its own predicate once the temporary range is gone
+    int threshold = 4;
+    auto above = easyfindIf(lst, [threshold](int value) { return value > threshold; }).begin();
+    size_t above_count = 0;
+    for (; !above.atEnd(); ++above)
+        ++above_count;
+    size_t above_expected = static_cast<size_t>(std::count_if(lst.begin(), lst.end(), [threshold](int value) { return value > threshold; }));
+    std::cout << (above_count == above_expected ? "✓ " : "✗ ")
+              << "easyfindIf iterator outlives its temporary range" << std::endl;
+}
+
 int main()
 {
     std::cout << "=== EASYFIND FUNCTION TESTS ===" << std::endl;
@@ -120,7 +757,35 @@ int main()
     duplicateVec.push_back(5);
     testContainer(duplicateVec, "duplicate-values std::vector", 5);  // Should find first occurrence
     
+    // Vectorised search on contiguous containers
+    std::cout << "\n=================== SIMD TESTS ===================" << std::endl;
+    testSimdSearch();
+    testValueTypes();
+    testAllMatches();
+    testParallelSearch();
+    
+    // Non-throwing variant
+    std::cout << "\n=================== NOTHROW TESTS ===================" << std::endl;
+    testNothrowSearch();
+    
+    // Batch lookups
+    std::cout << "\n=================== BATCH TESTS ===================" << std::endl;
+    testBatchSearch();
+    
+    // Structure-aware lookups
+    std::cout << "\n=================== SET AND SORTED TESTS ===================" << std::endl;
+    testSetSearch();
+    testSortedSearch();
+    testIndexedSearch();
+    
     std::cout << "\n=================== TESTS COMPLETE ===================" << std::endl;
     
+#ifdef CPP08_INSTRUMENT
+    // Built with make INSTRUMENT=1: write out what the hooks recorded
+    instrument::dump("easyfind_stats.json");
+    instrument::dump("easyfind_stats.prom", instrument::PROMETHEUS);
+    std::cout << "Instrumentation written to easyfind_stats.json and easyfind_stats.prom" << std::endl;
+#endif
+    
     return 0;
 }
@@ -0,0 +1,328 @@
+#include <vector>
+#include <list>
+#include <deque>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <cstdio>
+#include "bench.hpp"
+#include "span.hpp"
+#include "span_kernels.hpp"
+#include "mapped_span.hpp"
+#include "concurrent_span.hpp"
+#include "windowed_span.hpp"
+
+// Size used by the thread-scaling benchmarks
+static const unsigned int SCALING_SIZE = 1 << 20;
+
+static std::vector<int> randomNumbers(size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> dis(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    std::vector<int> numbers;
+    numbers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        numbers.push_back(dis(gen));
+    }
+    return numbers;
+}
+
+// Ingestion
+
+static void BM_AddNumber(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    while (state.keepRunning()) {
+        Span span(static_cast<unsigned int>(numbers.size()));
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            span.addNumber(numbers[i]);
+        }
+        doNotOptimize(span.size());
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_AddNumber, BENCH_ARGS_SIZES);
+
+template<typename Container>
+static void addNumbersFrom(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    Container source(numbers.begin(), numbers.end());
+    while (state.keepRunning()) {
+        Span span(static_cast<unsigned int>(numbers.size()));
+        span.addNumbers(source.begin(), source.end());
+        doNotOptimize(span.size());
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+
+static void BM_AddNumbers_Vector(BenchState& state) {
+    addNumbersFrom<std::vector<int> >(state);
+}
+BENCHMARK(BM_AddNumbers_Vector, BENCH_ARGS_SIZES);
+
+static void BM_AddNumbers_List(BenchState& state) {
+    addNumbersFrom<std::list<int> >(state);
+}
+BENCHMARK(BM_AddNumbers_List, BENCH_ARGS_SIZES);
+
+static void BM_AddNumbers_Deque(BenchState& state) {
+    addNumbersFrom<std::deque<int> >(state);
+}
+BENCHMARK(BM_AddNumbers_Deque, BENCH_ARGS_SIZES);
+
+// Pointer + length batches of 64 KiB, as read from a socket
+static void BM_AddNumbers_Chunked64K(BenchState& state) {
+    const size_t CHUNK = 16384;
+    std::vector<int> numbers = randomNumbers(state.arg());
+    while (state.keepRunning()) {
+        Span span(static_cast<unsigned int>(numbers.size()));
+        for (size_t offset = 0; offset < numbers.size(); offset += CHUNK) {
+            span.addNumbers(numbers.data() + offset, std::min(CHUNK, numbers.size() - offset));
+        }
+        doNotOptimize(span.size());
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_AddNumbers_Chunked64K, BENCH_ARGS_SIZES);
+
+// Queries
+
+static void BM_ShortestSpan(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    Span span(static_cast<unsigned int>(numbers.size()));
+    span.addNumbers(numbers.begin(), numbers.end());
+    while (state.keepRunning()) {
+        doNotOptimize(span.shortestSpan());
+    }
+}
+BENCHMARK(BM_ShortestSpan, BENCH_ARGS_SIZES);
+
+// A query after every add, over distinct values so the index is never
+// short-circuited by a duplicate
+static void BM_AddThenShortestSpan(BenchState& state) {
+    std::vector<int> numbers(state.arg());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        numbers[i] = static_cast<int>(i * 3);
+    }
+    std::shuffle(numbers.begin(), numbers.end(), std::mt19937(42));
+    while (state.keepRunning()) {
+        Span span(static_cast<unsigned int>(numbers.size()));
+        unsigned int shortest = 0;
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            span.addNumber(numbers[i]);
+            if (i > 0) {
+                shortest = span.shortestSpan();
+            }
+        }
+        doNotOptimize(shortest);
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_AddThenShortestSpan, BENCH_ARGS_SIZES);
+
+static void BM_LongestSpan(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    Span span(static_cast<unsigned int>(numbers.size()));
+    span.addNumbers(numbers.begin(), numbers.end());
+    while (state.keepRunning()) {
+        doNotOptimize(span.longestSpan());
+    }
+}
+BENCHMARK(BM_LongestSpan, BENCH_ARGS_SIZES);
+
+// Baseline: what shortestSpan did before the ordered index (copy, sort, scan)
+static void BM_ShortestSpan_SortBaseline(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    while (state.keepRunning()) {
+        std::vector<int> sorted_numbers(numbers);
+        std::sort(sorted_numbers.begin(), sorted_numbers.end());
+        unsigned int min_span = std::numeric_limits<unsigned int>::max();
+        for (size_t i = 1; i < sorted_numbers.size(); ++i) {
+            unsigned int current = static_cast<unsigned int>(sorted_numbers[i]) - static_cast<unsigned int>(sorted_numbers[i - 1]);
+            min_span = std::min(min_span, current);
+        }
+        doNotOptimize(min_span);
+    }
+}
+BENCHMARK(BM_ShortestSpan_SortBaseline, BENCH_ARGS_SIZES);
+
+// Baseline: what longestSpan did before running extremes (two scans)
+static void BM_LongestSpan_ScanBaseline(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    while (state.keepRunning()) {
+        int min_value = *std::min_element(numbers.begin(), numbers.end());
+        int max_value = *std::max_element(numbers.begin(), numbers.end());
+        doNotOptimize(static_cast<unsigned int>(max_value) - static_cast<unsigned int>(min_value));
+    }
+}
+BENCHMARK(BM_LongestSpan_ScanBaseline, BENCH_ARGS_SIZES);
+
+// Kernels
+
+static void minMaxWith(BenchState& state, SpanKernelIsa isa) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    SpanKernelIsa previous = spanKernelIsa();
+    setSpanKernelIsa(isa);
+    while (state.keepRunning()) {
+        int low, high;
+        spanMinMax(numbers.data(), numbers.size(), low, high);
+        doNotOptimize(low);
+        doNotOptimize(high);
+    }
+    setSpanKernelIsa(previous);
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+
+static void BM_MinMax_Scalar(BenchState& state) {
+    minMaxWith(state, SPAN_ISA_SCALAR);
+}
+BENCHMARK(BM_MinMax_Scalar, BENCH_ARGS_SIZES);
+
+static void BM_MinMax_BestIsa(BenchState& state) {
+    minMaxWith(state, spanKernelBestIsa());
+}
+BENCHMARK(BM_MinMax_BestIsa, BENCH_ARGS_SIZES);
+
+static void minGapWith(BenchState& state, SpanKernelIsa isa) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    std::sort(numbers.begin(), numbers.end());
+    SpanKernelIsa previous = spanKernelIsa();
+    setSpanKernelIsa(isa);
+    while (state.keepRunning()) {
+        doNotOptimize(spanMinAdjacentGap(numbers.data(), numbers.size()));
+    }
+    setSpanKernelIsa(previous);
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+
+static void BM_MinGap_Scalar(BenchState& state) {
+    minGapWith(state, SPAN_ISA_SCALAR);
+}
+BENCHMARK(BM_MinGap_Scalar, BENCH_ARGS_SIZES);
+
+static void BM_MinGap_BestIsa(BenchState& state) {
+    minGapWith(state, spanKernelBestIsa());
+}
+BENCHMARK(BM_MinGap_BestIsa, BENCH_ARGS_SIZES);
+
+static void sortWith(BenchState& state, SpanSortStrategy strategy) {
+    std::vector<int> numbers = randomNumbers(state.arg());
+    std::vector<int> work(numbers.size());
+    std::vector<int> scratch(numbers.size());
+    while (state.keepRunning()) {
+        std::copy(numbers.begin(), numbers.end(), work.begin());
+        spanSort(work.data(), work.size(), strategy, scratch.data());
+        doNotOptimize(work[0]);
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+
+static void BM_Sort_Comparison(BenchState& state) {
+    sortWith(state, SPAN_SORT_COMPARISON);
+}
+BENCHMARK(BM_Sort_Comparison, BENCH_ARGS_SIZES);
+
+static void BM_Sort_Radix(BenchState& state) {
+    sortWith(state, SPAN_SORT_RADIX);
+}
+BENCHMARK(BM_Sort_Radix, BENCH_ARGS_SIZES);
+
+// Variants
+
+static void BM_MappedSpan_Reopen(BenchState& state) {
+    const char* path = "span_bench_mapped.bin";
+    std::vector<int> numbers = randomNumbers(state.arg());
+    {
+        MappedSpan span(path, static_cast<unsigned int>(numbers.size()));
+        span.addNumbers(numbers.data(), numbers.size());
+        span.sort();
+    }
+    while (state.keepRunning()) {
+        MappedSpan span(path);
+        doNotOptimize(span.longestSpan());
+    }
+    std::remove(path);
+}
+BENCHMARK(BM_MappedSpan_Reopen, BENCH_ARGS_SIZES);
+
+// One push plus both queries, with the window size as the argument
+static void BM_WindowedSpan_Push(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(1 << 16);
+    WindowedSpan window(static_cast<unsigned int>(state.arg()));
+    for (int64_t i = 0; i < state.arg(); ++i) {
+        window.addNumber(numbers[i % numbers.size()]);
+    }
+    size_t next = 0;
+    while (state.keepRunning()) {
+        window.addNumber(numbers[next]);
+        next = (next + 1) % numbers.size();
+        doNotOptimize(window.shortestSpan() + window.longestSpan());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WindowedSpan_Push, BENCH_ARGS_SIZES);
+
+// Thread scaling (argument = thread count)
+
+static void BM_BulkLoad(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(SCALING_SIZE);
+    while (state.keepRunning()) {
+        Span span(SCALING_SIZE);
+        span.setThreads(static_cast<unsigned int>(state.arg()));
+        span.addNumbers(numbers.begin(), numbers.end());
+        doNotOptimize(span.shortestSpan());
+    }
+    state.setItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_BulkLoad, BENCH_ARGS_THREADS);
+
+template<typename Producer>
+static void runProducers(unsigned int threads, Producer producer) {
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; ++t) {
+        pool.push_back(std::thread(producer, t));
+    }
+    for (size_t t = 0; t < pool.size(); ++t) {
+        pool[t].join();
+    }
+}
+
+static void BM_MutexSpan_AddNumber(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(SCALING_SIZE);
+    unsigned int threads = static_cast<unsigned int>(state.arg());
+    unsigned int per_thread = SCALING_SIZE / threads;
+    while (state.keepRunning()) {
+        Span span(SCALING_SIZE);
+        std::mutex lock;
+        runProducers(threads, [&](unsigned int t) {
+            for (unsigned int i = t * per_thread; i < (t + 1) * per_thread; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+                span.addNumber(numbers[i]);
+            }
+        });
+        doNotOptimize(span.size());
+    }
+    state.setItemsProcessed(state.iterations() * per_thread * threads);
+}
+BENCHMARK(BM_MutexSpan_AddNumber, BENCH_ARGS_THREADS);
+
+static void BM_ConcurrentSpan_AddNumber(BenchState& state) {
+    std::vector<int> numbers = randomNumbers(SCALING_SIZE);
+    unsigned int threads = static_cast<unsigned int>(state.arg());
+    unsigned int per_thread = SCALING_SIZE / threads;
+    while (state.keepRunning()) {
+        ConcurrentSpan span(SCALING_SIZE);
+        runProducers(threads, [&](unsigned int t) {
+            for (unsigned int i = t * per_thread; i < (t + 1) * per_thread; ++i) {
+                span.addNumber(numbers[i]);
+            }
+        });
+        doNotOptimize(span.size());
+    }
+    state.setItemsProcessed(state.iterations() * per_thread * threads);
+}
+BENCHMARK(BM_ConcurrentSpan_AddNumber, BENCH_ARGS_THREADS);
+
+int main(int argc, char** argv) {
+    return runBenchmarks(argc, argv);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Minimal Google-Benchmark-style harness
+ *
+ * A benchmark is a function taking a BenchState. Work before the
+ * keepRunning() loop is setup and is not timed:
+ *
+ *     static void BM_Example(BenchState& state) {
+ *         std::vector<int> data = makeData(state.arg());
+ *         while (state.keepRunning()) {
+ *             doNotOptimize(work(data));
+ *         }
+ *         state.setItemsProcessed(state.iterations() * data.size());
+ *     }
+ *     BENCHMARK(BM_Example, BENCH_ARGS_SIZES);
+ *
+ * The harness picks the iteration count so each benchmark runs for at
+ * least --min_time seconds, counts heap allocations made inside the timed
+ * loop, and reports a console table plus optional JSON (--out=<file>).
+ */
+class BenchState {
+private:
+    int64_t _arg;
+    uint64_t _iterations;
+    uint64_t _remaining;
+    bool _started;
+    double _startNs;
+    double _elapsedNs;
+    uint64_t _startAllocs;
+    uint64_t _allocs;
+    uint64_t _items;
+    bool _paused;
+
+public:
+    BenchState(int64_t arg, uint64_t iterations);
+
+    // Loop condition: starts the timer on the first call, stops it on the last
+    bool keepRunning();
+
+    // Exclude a region inside the loop from timing and allocation counts
+    void pauseTiming();
+    void resumeTiming();
+
+    int64_t arg() const;
+    uint64_t iterations() const;
+    void setItemsProcessed(uint64_t items);
+
+    double elapsedNs() const;
+    uint64_t allocations() const;
+    uint64_t itemsProcessed() const;
+};
+
+typedef void (*BenchFunction)(BenchState& state);
+
+// Argument sets expanded at run time
+enum BenchArgs {
+    BENCH_ARGS_NONE,     // Single run, arg() == 0
+    BENCH_ARGS_SIZES,    // 10^2, 10^3, ... up to --max_size
+    BENCH_ARGS_THREADS   // 1, 2, 4, ... up to the core count (at least 4)
+};
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction function, BenchArgs args);
+};
+
+#define BENCHMARK(function, args) \
+    static BenchRegistrar function##_registrar(#function, function, args)
+
+// Heap allocations made by this process so far
+uint64_t benchAllocationCount();
+
+// Keeps the optimizer from discarding a benchmarked result
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Parse flags and run every registered benchmark
+ * --filter=<substring>  only run benchmarks whose name contains it
+ * --max_size=<n>        largest size for BENCH_ARGS_SIZES (default 10^6)
+ * --min_time=<seconds>  minimum timed duration per benchmark (default 0.2)
+ * --out=<file>          also write the results as JSON
+ */
+int runBenchmarks(int argc, char** argv);
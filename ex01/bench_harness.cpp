@@ -0,0 +1,306 @@
+#include "bench.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <atomic>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#define CYAN "\033[36m"
+#define RESET "\033[0m"
+
+// Allocation counting: every global operator new goes through here
+static std::atomic<uint64_t> g_allocations(0);
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* pointer = std::malloc(size);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+uint64_t benchAllocationCount() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+static double nowNs() {
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// BenchState
+BenchState::BenchState(int64_t arg, uint64_t iterations)
+    : _arg(arg), _iterations(iterations), _remaining(iterations), _started(false),
+      _startNs(0), _elapsedNs(0), _startAllocs(0), _allocs(0), _items(0), _paused(false) {
+}
+
+bool BenchState::keepRunning() {
+    if (!_started) {
+        _started = true;
+        resumeTiming();
+    }
+    if (_remaining == 0) {
+        pauseTiming();
+        return false;
+    }
+    --_remaining;
+    return true;
+}
+
+void BenchState::pauseTiming() {
+    if (!_paused) {
+        _elapsedNs += nowNs() - _startNs;
+        _allocs += benchAllocationCount() - _startAllocs;
+        _paused = true;
+    }
+}
+
+void BenchState::resumeTiming() {
+    _paused = false;
+    _startAllocs = benchAllocationCount();
+    _startNs = nowNs();
+}
+
+int64_t BenchState::arg() const {
+    return _arg;
+}
+
+uint64_t BenchState::iterations() const {
+    return _iterations;
+}
+
+void BenchState::setItemsProcessed(uint64_t items) {
+    _items = items;
+}
+
+double BenchState::elapsedNs() const {
+    return _elapsedNs;
+}
+
+uint64_t BenchState::allocations() const {
+    return _allocs;
+}
+
+uint64_t BenchState::itemsProcessed() const {
+    return _items;
+}
+
+// Registry
+struct BenchEntry {
+    std::string name;
+    BenchFunction function;
+    BenchArgs args;
+};
+
+static std::vector<BenchEntry>& registry() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function, BenchArgs args) {
+    BenchEntry entry;
+    entry.name = name;
+    entry.function = function;
+    entry.args = args;
+    registry().push_back(entry);
+}
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerIteration;
+    double itemsPerSecond;
+    double allocsPerIteration;
+};
+
+static std::vector<int64_t> expandArgs(BenchArgs args, int64_t max_size) {
+    std::vector<int64_t> values;
+    if (args == BENCH_ARGS_SIZES) {
+        for (int64_t size = 100; size <= max_size; size *= 10) {
+            values.push_back(size);
+        }
+    } else if (args == BENCH_ARGS_THREADS) {
+        int64_t cores = std::thread::hardware_concurrency();
+        if (cores < 4) {
+            cores = 4;
+        }
+        for (int64_t threads = 1; threads <= cores; threads *= 2) {
+            values.push_back(threads);
+        }
+    } else {
+        values.push_back(0);
+    }
+    return values;
+}
+
+// Grow the iteration count until the timed loop lasts at least min_time
+static BenchResult runOne(const BenchEntry& entry, int64_t arg, double min_time_ns) {
+    uint64_t iterations = 1;
+    for (;;) {
+        BenchState state(arg, iterations);
+        entry.function(state);
+
+        double elapsed = state.elapsedNs();
+        if (elapsed >= min_time_ns || iterations >= 1000000000ull) {
+            BenchResult result;
+            result.name = entry.name;
+            if (entry.args != BENCH_ARGS_NONE) {
+                result.name += "/" + std::to_string(arg);
+            }
+            result.iterations = iterations;
+            result.nsPerIteration = elapsed / iterations;
+            result.itemsPerSecond = state.itemsProcessed() == 0 || elapsed <= 0
+                ? 0 : state.itemsProcessed() * 1e9 / elapsed;
+            result.allocsPerIteration = static_cast<double>(state.allocations()) / iterations;
+            return result;
+        }
+
+        // Aim 40% past the target, growing at most 10x per step
+        double scale = elapsed <= 0 ? 10 : min_time_ns * 1.4 / elapsed;
+        if (scale > 10) {
+            scale = 10;
+        }
+        uint64_t next = static_cast<uint64_t>(iterations * scale);
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+static std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '"' || text[i] == '\\') {
+            escaped += '\\';
+        }
+        escaped += text[i];
+    }
+    return escaped;
+}
+
+static void writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+    std::ofstream out(path.c_str());
+    if (!out) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return;
+    }
+
+    char date[64];
+    std::time_t now = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n"
+        << "  },\n"
+        << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << jsonEscape(result.name) << "\",\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << std::setprecision(6) << std::fixed
+            << "      \"real_time\": " << result.nsPerIteration << ",\n"
+            << "      \"time_unit\": \"ns\",\n"
+            << "      \"items_per_second\": " << result.itemsPerSecond << ",\n"
+            << "      \"allocs_per_iter\": " << result.allocsPerIteration << "\n"
+            << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static bool flagValue(const char* argument, const char* flag, std::string& value) {
+    size_t length = std::strlen(flag);
+    if (std::strncmp(argument, flag, length) == 0 && argument[length] == '=') {
+        value = argument + length + 1;
+        return true;
+    }
+    return false;
+}
+
+int runBenchmarks(int argc, char** argv) {
+    std::string filter;
+    std::string out_path;
+    int64_t max_size = 1000000;
+    double min_time = 0.2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (flagValue(argv[i], "--filter", value)) {
+            filter = value;
+        } else if (flagValue(argv[i], "--max_size", value)) {
+            max_size = std::strtoll(value.c_str(), NULL, 10);
+        } else if (flagValue(argv[i], "--min_time", value)) {
+            min_time = std::strtod(value.c_str(), NULL);
+        } else if (flagValue(argv[i], "--out", value)) {
+            out_path = value;
+        } else {
+            std::cerr << "Unknown flag: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << CYAN << std::left << std::setw(44) << "Benchmark" << std::right
+              << std::setw(16) << "Time (ns)"
+              << std::setw(14) << "Iterations"
+              << std::setw(16) << "Items/s"
+              << std::setw(14) << "Allocs/iter" << RESET << std::endl;
+
+    std::vector<BenchResult> results;
+    const std::vector<BenchEntry>& entries = registry();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!filter.empty() && entries[i].name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::vector<int64_t> args = expandArgs(entries[i].args, max_size);
+        for (size_t a = 0; a < args.size(); ++a) {
+            BenchResult result = runOne(entries[i], args[a], min_time * 1e9);
+            results.push_back(result);
+
+            std::ostringstream items;
+            if (result.itemsPerSecond > 0) {
+                items << std::fixed << std::setprecision(1) << result.itemsPerSecond / 1e6 << "M";
+            }
+            std::cout << std::left << std::setw(44) << result.name << std::right
+                      << std::setw(16) << std::fixed << std::setprecision(1) << result.nsPerIteration
+                      << std::setw(14) << result.iterations
+                      << std::setw(16) << items.str()
+                      << std::setw(14) << std::setprecision(2) << result.allocsPerIteration << std::endl;
+        }
+    }
+
+    if (!out_path.empty()) {
+        writeJson(out_path, results);
+        std::cout << "Results written to " << out_path << std::endl;
+    }
+    return 0;
+}
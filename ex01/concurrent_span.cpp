@@ -0,0 +1,118 @@
+#include "concurrent_span.hpp"
+#include <limits>
+#include <thread>
+
+// Constructor
+ConcurrentSpan::ConcurrentSpan(unsigned int N)
+    : _numbers(N), _maxSize(N), _reserved(0), _committed(0),
+      _min(std::numeric_limits<int>::max()), _max(std::numeric_limits<int>::min()) {
+}
+
+// Destructor
+ConcurrentSpan::~ConcurrentSpan() {}
+
+// Reserve count consecutive slots or throw without reserving any
+size_t ConcurrentSpan::reserve(size_t count) {
+    size_t first = _reserved.load(std::memory_order_relaxed);
+    do {
+        if (first > _maxSize || count > _maxSize - first) {
+            throw Span::RangeTooBigException();
+        }
+    } while (!_reserved.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+    return first;
+}
+
+// Fold freshly written slots into the extremes, then make them visible
+void ConcurrentSpan::publish(size_t first, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    int low, high;
+    spanMinMax(&_numbers[first], count, low, high);
+    updateExtremes(low, high);
+    _committed.fetch_add(count, std::memory_order_release);
+}
+
+void ConcurrentSpan::updateExtremes(int low, int high) {
+    int current = _min.load(std::memory_order_relaxed);
+    while (low < current && !_min.compare_exchange_weak(current, low, std::memory_order_relaxed)) {
+    }
+    current = _max.load(std::memory_order_relaxed);
+    while (high > current && !_max.compare_exchange_weak(current, high, std::memory_order_relaxed)) {
+    }
+}
+
+// Add a single number: one fetch-add reserves the slot. A thread only
+// gets a slot index past the end once every slot has been handed out,
+// so exactly _maxSize adds succeed.
+void ConcurrentSpan::addNumber(int number) {
+    size_t slot = _reserved.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= _maxSize) {
+        throw Span::SpanFullException();
+    }
+    _numbers[slot] = number;
+    updateExtremes(number, number);
+    _committed.fetch_add(1, std::memory_order_release);
+}
+
+// Add a contiguous batch: one reservation and one block copy
+void ConcurrentSpan::addNumbers(const int* numbers, size_t count) {
+    size_t first = reserve(count);
+    std::copy(numbers, numbers + count, _numbers.begin() + first);
+    publish(first, count);
+}
+
+// Sort a snapshot of the stored values once no add is in flight.
+// _committed is loaded before _reserved: slots are always reserved before
+// they are committed, so if the later reserved count still equals the
+// earlier committed count, every slot reserved at that point was written.
+// Loading in the other order lets a later add's commit stand in for an
+// earlier, still unwritten slot.
+unsigned int ConcurrentSpan::shortestSpan() const {
+    size_t count;
+    for (;;) {
+        count = _committed.load(std::memory_order_acquire);
+        size_t reserved = _reserved.load(std::memory_order_acquire);
+        if (reserved > _maxSize) {
+            reserved = _maxSize;
+        }
+        if (count == reserved) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    if (count < 2) {
+        throw Span::NoSpanException();
+    }
+
+    std::vector<int> sorted_numbers(_numbers.begin(), _numbers.begin() + count);
+    std::vector<int> scratch(count);
+    spanSort(sorted_numbers.data(), count, SPAN_SORT_AUTO, scratch.data());
+    return spanMinAdjacentGap(sorted_numbers.data(), count);
+}
+
+// Extremes are maintained by the adds
+unsigned int ConcurrentSpan::longestSpan() const {
+    if (_committed.load(std::memory_order_acquire) < 2) {
+        throw Span::NoSpanException();
+    }
+    return static_cast<unsigned int>(_max.load(std::memory_order_relaxed))
+         - static_cast<unsigned int>(_min.load(std::memory_order_relaxed));
+}
+
+// Utility functions
+unsigned int ConcurrentSpan::size() const {
+    return static_cast<unsigned int>(_committed.load(std::memory_order_acquire));
+}
+
+unsigned int ConcurrentSpan::maxSize() const {
+    return _maxSize;
+}
+
+bool ConcurrentSpan::empty() const {
+    return size() == 0;
+}
+
+bool ConcurrentSpan::full() const {
+    return _reserved.load(std::memory_order_relaxed) >= _maxSize;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "span.hpp"
+
+/**
+ * ConcurrentSpan - a Span that many threads can add to at once
+ *
+ * addNumber/addNumbers are lock-free: slots are reserved with an atomic
+ * add on the size (a compare-and-swap for ranges, so a range that does not
+ * fit reserves nothing), and the running min/max are updated with CAS
+ * loops. Exactly maxSize() values are accepted; every add past that
+ * throws the same exceptions as Span.
+ *
+ * Queries may run concurrently with adds but only see values whose add has
+ * completed; shortestSpan waits for in-flight adds so that it scans fully
+ * written slots.
+ */
+class ConcurrentSpan {
+private:
+    std::vector<int> _numbers;
+    unsigned int _maxSize;
+
+    // Slots handed out; may run past _maxSize by failed single adds
+    std::atomic<size_t> _reserved;
+    // Slots written
+    std::atomic<size_t> _committed;
+
+    std::atomic<int> _min;
+    std::atomic<int> _max;
+
+    size_t reserve(size_t count);
+    void publish(size_t first, size_t count);
+    void updateExtremes(int low, int high);
+
+    // Atomics are neither copyable nor movable
+    ConcurrentSpan(const ConcurrentSpan& other);
+    ConcurrentSpan& operator=(const ConcurrentSpan& other);
+
+public:
+    // Constructor
+    explicit ConcurrentSpan(unsigned int N);
+
+    // Destructor
+    ~ConcurrentSpan();
+
+    // Member functions (safe to call from any number of threads)
+    void addNumber(int number);
+
+    template<typename Iterator>
+    void addNumbers(Iterator begin, Iterator end);
+
+    void addNumbers(const int* numbers, size_t count);
+
+    unsigned int shortestSpan() const;
+    unsigned int longestSpan() const;
+
+    // Utility functions
+    unsigned int size() const;
+    unsigned int maxSize() const;
+    bool empty() const;
+    bool full() const;
+};
+
+// Template function implementation (must be in header)
+template<typename Iterator>
+void ConcurrentSpan::addNumbers(Iterator begin, Iterator end) {
+    typedef typename std::iterator_traits<Iterator>::iterator_category category;
+
+    if constexpr (std::contiguous_iterator<Iterator>
+                  && std::is_same_v<std::iter_value_t<Iterator>, int>) {
+        addNumbers(std::to_address(begin), static_cast<size_t>(end - begin));
+    } else if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+        // Size is known up front: reserve, then write straight into the slots
+        size_t count = std::distance(begin, end);
+        size_t first = reserve(count);
+        for (size_t slot = first; begin != end; ++begin, ++slot) {
+            _numbers[slot] = *begin;
+        }
+        publish(first, count);
+    } else {
+        // Single-pass input: stage locally so the slot count is known
+        std::vector<int> staged(begin, end);
+        addNumbers(staged.data(), staged.size());
+    }
+}
@@ -1,10 +1,22 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <deque>
+#include <sstream>
+#include <iterator>
 #include <random>
 #include <chrono>
 #include <iomanip>
+#include <limits>
 #include "span.hpp"
+#include "span_kernels.hpp"
+#include "mapped_span.hpp"
+#include "concurrent_span.hpp"
+#include "windowed_span.hpp"
+#include "instrument.hpp"
+#include <thread>
+#include <atomic>
+#include <cstdio>
 
 // Test colors for output
 #define GREEN "\033[32m"
@@ -128,6 +140,691 @@ void testRangeAddition() {
     }
 }
 
+// Test that shortestSpan stays correct after every single insert
+void testIncrementalShortestSpan() {
+    std::cout << BLUE << "\n=== INCREMENTAL SHORTEST SPAN TEST ===" << RESET << std::endl;
+    
+    const unsigned int SIZE = 2000;
+    
+    try {
+        Span span(SIZE);
+        std::vector<int> added;
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> dis(-1000000, 1000000);
+        
+        bool all_match = true;
+        for (unsigned int i = 0; i < SIZE; ++i) {
+            int value = dis(gen);
+            span.addNumber(value);
+            added.push_back(value);
+            if (added.size() < 2) {
+                continue;
+            }
+            
+            // Brute force reference over a sorted copy
+            std::vector<int> sorted_copy(added);
+            std::sort(sorted_copy.begin(), sorted_copy.end());
+            unsigned int expected = std::numeric_limits<unsigned int>::max();
+            for (size_t j = 1; j < sorted_copy.size(); ++j) {
+                unsigned int gap = static_cast<unsigned int>(sorted_copy[j] - sorted_copy[j - 1]);
+                if (gap < expected) {
+                    expected = gap;
+                }
+            }
+            if (span.shortestSpan() != expected) {
+                all_match = false;
+                break;
+            }
+        }
+        
+        // Several adds between queries: each query merges a sorted batch
+        // into the lazily built index
+        Span batched(SIZE * 4);
+        std::vector<int> batched_added;
+        std::uniform_int_distribution<> batch_size(1, 40);
+        std::uniform_int_distribution<> wide(-1000000000, 1000000000);  // Duplicates unlikely
+        while (all_match && batched_added.size() + 40 <= SIZE * 4) {
+            int count = batch_size(gen);
+            std::vector<int> batch;
+            for (int j = 0; j < count; ++j) {
+                batch.push_back(wide(gen));
+            }
+            if (count % 2 == 0) {
+                batched.addNumbers(batch.begin(), batch.end());
+            } else {
+                for (size_t j = 0; j < batch.size(); ++j) {
+                    batched.addNumber(batch[j]);
+                }
+            }
+            batched_added.insert(batched_added.end(), batch.begin(), batch.end());
+            if (batched_added.size() < 2) {
+                continue;
+            }
+            std::vector<int> sorted_copy(batched_added);
+            std::sort(sorted_copy.begin(), sorted_copy.end());
+            unsigned int expected = std::numeric_limits<unsigned int>::max();
+            for (size_t j = 1; j < sorted_copy.size(); ++j) {
+                expected = std::min(expected, static_cast<unsigned int>(sorted_copy[j] - sorted_copy[j - 1]));
+            }
+            if (batched.shortestSpan() != expected) {
+                all_match = false;
+            }
+        }
+        
+        // Extreme values must not overflow
+        Span extremes(2);
+        extremes.addNumber(std::numeric_limits<int>::min());
+        extremes.addNumber(std::numeric_limits<int>::max());
+        std::cout << "INT_MIN..INT_MAX shortest span: " << extremes.shortestSpan() << std::endl;
+        
+        if (all_match && extremes.shortestSpan() == std::numeric_limits<unsigned int>::max()) {
+            std::cout << GREEN << "✓ Incremental shortest span matches brute force after every insert!" << RESET << std::endl;
+        } else {
+            std::cout << RED << "✗ Incremental shortest span diverged from brute force" << RESET << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "✗ Incremental shortest span test failed: " << e.what() << RESET << std::endl;
+    }
+}
+
+// Test that longestSpan follows the running extremes
+void testRunningExtremes() {
+    std::cout << BLUE << "\n=== RUNNING MIN/MAX TEST ===" << RESET << std::endl;
+    
+    try {
+        Span span(1000);
+        std::mt19937 gen(7);
+        std::uniform_int_distribution<> dis(-50000, 50000);
+        int min_value = std::numeric_limits<int>::max();
+        int max_value = std::numeric_limits<int>::min();
+        
+        bool all_match = true;
+        for (int i = 0; i < 500; ++i) {
+            int value = dis(gen);
+            span.addNumber(value);
+            min_value = std::min(min_value, value);
+            max_value = std::max(max_value, value);
+            if (i > 0 && span.longestSpan() != static_cast<unsigned int>(max_value - min_value)) {
+                all_match = false;
+            }
+        }
+        
+        // Range insertion must update the extremes too
+        std::vector<int> range = {-60000, 60000};
+        span.addNumbers(range.begin(), range.end());
+        std::cout << "Longest span after range: " << span.longestSpan() << std::endl;
+        
+        Span extremes(2);
+        extremes.addNumber(std::numeric_limits<int>::max());
+        extremes.addNumber(std::numeric_limits<int>::min());
+        std::cout << "INT_MIN..INT_MAX longest span: " << extremes.longestSpan() << std::endl;
+        
+        if (all_match && span.longestSpan() == 120000
+            && extremes.longestSpan() == std::numeric_limits<unsigned int>::max()) {
+            std::cout << GREEN << "✓ Running min/max test passed!" << RESET << std::endl;
+        } else {
+            std::cout << RED << "✗ Running min/max diverged from brute force" << RESET << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "✗ Running min/max test failed: " << e.what() << RESET << std::endl;
+    }
+}
+
+// Test every available kernel instruction set against std:: reference results
+void testScanKernels() {
+    std::cout << BLUE << "\n=== SIMD SCAN KERNELS TEST ===" << RESET << std::endl;
+    
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<> dis(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    SpanKernelIsa best = spanKernelBestIsa();
+    std::cout << "Best instruction set: " << spanKernelIsaName(best) << std::endl;
+    
+    bool all_match = true;
+    for (int isa = SPAN_ISA_SCALAR; isa <= best; ++isa) {
+        setSpanKernelIsa(static_cast<SpanKernelIsa>(isa));
+        for (size_t size = 2; size < 300 && all_match; size += (size < 40 ? 1 : 37)) {
+            std::vector<int> data(size);
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = dis(gen);
+            }
+            
+            int min_value, max_value;
+            spanMinMax(data.data(), data.size(), min_value, max_value);
+            if (min_value != *std::min_element(data.begin(), data.end())
+                || max_value != *std::max_element(data.begin(), data.end())) {
+                all_match = false;
+            }
+            
+            std::sort(data.begin(), data.end());
+            unsigned int expected = std::numeric_limits<unsigned int>::max();
+            for (size_t i = 1; i < size; ++i) {
+                expected = std::min(expected, static_cast<unsigned int>(data[i]) - static_cast<unsigned int>(data[i - 1]));
+            }
+            if (spanMinAdjacentGap(data.data(), data.size()) != expected) {
+                all_match = false;
+            }
+        }
+        std::cout << "Checked " << spanKernelIsaName(static_cast<SpanKernelIsa>(isa)) << " kernels" << std::endl;
+    }
+    setSpanKernelIsa(best);
+    
+    // A large batch goes through the sort + gap scan rebuild path
+    Span span(5000);
+    span.addNumber(1000);
+    std::vector<int> batch;
+    for (int i = 0; i < 4000; ++i) {
+        batch.push_back(i * 7);
+    }
+    span.addNumbers(batch.begin(), batch.end());  // 1000 sits next to the batch's 1001
+    if (span.shortestSpan() != 1 || span.longestSpan() != 3999 * 7) {
+        all_match = false;
+    }
+    
+    if (all_match) {
+        std::cout << GREEN << "✓ SIMD scan kernels match reference results!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ SIMD scan kernels diverged from reference results" << RESET << std::endl;
+    }
+}
+
+// Test that the parallel paths give exactly the serial results
+void testParallelExecution() {
+    std::cout << BLUE << "\n=== PARALLEL EXECUTION TEST ===" << RESET << std::endl;
+    
+    std::mt19937 gen(99);
+    std::uniform_int_distribution<> dis(-100000000, 100000000);
+    bool all_match = true;
+    
+    // Kernels, including chunk counts that do not divide the input evenly
+    for (size_t size = 2; size < 2000 && all_match; size = size * 3 + 1) {
+        std::vector<int> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = dis(gen);
+        }
+        std::vector<int> serial(data);
+        std::sort(serial.begin(), serial.end());
+        unsigned int serial_gap = spanMinAdjacentGap(serial.data(), serial.size());
+        int serial_min, serial_max;
+        spanMinMax(data.data(), data.size(), serial_min, serial_max);
+        
+        for (unsigned int threads = 1; threads <= 8; ++threads) {
+            std::vector<int> parallel(data);
+            std::vector<int> scratch(data.size());
+            spanParallelSort(parallel.data(), parallel.size(), threads, SPAN_SORT_AUTO, scratch.data());
+            int parallel_min, parallel_max;
+            spanParallelMinMax(data.data(), data.size(), threads, parallel_min, parallel_max);
+            if (parallel != serial
+                || spanParallelMinAdjacentGap(parallel.data(), parallel.size(), threads) != serial_gap
+                || parallel_min != serial_min || parallel_max != serial_max) {
+                all_match = false;
+            }
+        }
+    }
+    
+    // Whole Span with a batch big enough to be split across threads
+    const unsigned int SIZE = 300000;
+    std::vector<int> batch(SIZE);
+    for (unsigned int i = 0; i < SIZE; ++i) {
+        batch[i] = static_cast<int>(i) * 3;
+    }
+    batch[SIZE / 2] += 1;  // Single closest pair, with gap 2
+    std::shuffle(batch.begin(), batch.end(), gen);
+    Span serial_span(SIZE);
+    Span parallel_span(SIZE);
+    parallel_span.setThreads(4);
+    serial_span.addNumbers(batch.begin(), batch.end());
+    parallel_span.addNumbers(batch.begin(), batch.end());
+    std::cout << "Threads: " << parallel_span.threads()
+              << ", shortest span: " << parallel_span.shortestSpan()
+              << ", longest span: " << parallel_span.longestSpan() << std::endl;
+    if (serial_span.shortestSpan() != parallel_span.shortestSpan() || parallel_span.shortestSpan() != 2
+        || serial_span.longestSpan() != parallel_span.longestSpan()) {
+        all_match = false;
+    }
+    
+    if (all_match) {
+        std::cout << GREEN << "✓ Parallel results match the serial path!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Parallel results diverged from the serial path" << RESET << std::endl;
+    }
+}
+
+// Test the radix sort backend and the sort strategy selection
+void testSortStrategies() {
+    std::cout << BLUE << "\n=== SORT STRATEGY TEST ===" << RESET << std::endl;
+    
+    std::mt19937 gen(2024);
+    std::uniform_int_distribution<> full(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+    std::uniform_int_distribution<> narrow(-300, 300);
+    bool all_match = true;
+    
+    // Full range (all passes), narrow range (upper passes skipped), constant input
+    for (int kind = 0; kind < 3; ++kind) {
+        std::vector<int> data(5001);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = kind == 0 ? full(gen) : (kind == 1 ? narrow(gen) : 42);
+        }
+        data[0] = std::numeric_limits<int>::min();
+        data[1] = std::numeric_limits<int>::max();
+        
+        std::vector<int> expected(data);
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> scratch(data.size());
+        spanRadixSort(data.data(), data.size(), scratch.data());
+        if (data != expected) {
+            all_match = false;
+        }
+    }
+    
+    // Every strategy gives the same spans through the rebuild path
+    std::vector<int> batch(10000);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i] = full(gen);
+    }
+    SpanSortStrategy strategies[] = { SPAN_SORT_AUTO, SPAN_SORT_COMPARISON, SPAN_SORT_RADIX };
+    unsigned int reference = 0;
+    for (int i = 0; i < 3; ++i) {
+        Span span(static_cast<unsigned int>(batch.size()));
+        span.setSortStrategy(strategies[i]);
+        span.addNumbers(batch.begin(), batch.end());
+        if (i == 0) {
+            reference = span.shortestSpan();
+            std::cout << "Shortest span over " << batch.size() << " random ints: " << reference << std::endl;
+        } else if (span.shortestSpan() != reference || span.sortStrategy() != strategies[i]) {
+            all_match = false;
+        }
+    }
+    
+    if (all_match) {
+        std::cout << GREEN << "✓ Radix sort and strategy selection passed!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Radix sort diverged from std::sort" << RESET << std::endl;
+    }
+}
+
+// Test the bulk ingestion paths
+void testBulkIngestion() {
+    std::cout << BLUE << "\n=== BULK INGESTION TEST ===" << RESET << std::endl;
+    
+    bool all_passed = true;
+    
+    // Pointer + length batches, as read from a socket buffer
+    try {
+        const size_t CHUNK = 16384;  // 64 KiB of ints
+        std::vector<int> buffer(CHUNK * 3);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer[i] = static_cast<int>(i * 2);
+        }
+        Span span(static_cast<unsigned int>(buffer.size()));
+        for (size_t offset = 0; offset < buffer.size(); offset += CHUNK) {
+            span.addNumbers(buffer.data() + offset, CHUNK);
+        }
+        std::cout << "Chunked batches - Size: " << span.size() << ", Shortest: " << span.shortestSpan()
+                  << ", Longest: " << span.longestSpan() << std::endl;
+        if (span.size() != buffer.size() || span.shortestSpan() != 2 || !span.full()) {
+            all_passed = false;
+        }
+        span.addNumbers(buffer.data(), 0);  // Empty batch on a full span is fine
+        span.addNumbers(buffer.data(), 1);
+        all_passed = false;
+    } catch (const Span::RangeTooBigException& e) {
+        std::cout << "Batch past capacity: " << e.what() << std::endl;
+    }
+    
+    // Single-pass input iterators
+    try {
+        std::istringstream stream("8 3 15 -4 42");
+        Span span(5);
+        span.addNumbers(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        std::cout << "Input iterators - Size: " << span.size() << ", Shortest: " << span.shortestSpan()
+                  << ", Longest: " << span.longestSpan() << std::endl;
+        if (span.size() != 5 || span.shortestSpan() != 5 || span.longestSpan() != 46) {
+            all_passed = false;
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "Input iterators: " << e.what() << RESET << std::endl;
+        all_passed = false;
+    }
+    
+    // Random-access but not contiguous
+    try {
+        std::deque<int> numbers = {10, 40, 25};
+        Span span(3);
+        span.addNumbers(numbers.begin(), numbers.end());
+        if (span.shortestSpan() != 15 || span.longestSpan() != 30) {
+            all_passed = false;
+        }
+    } catch (const std::exception&) {
+        all_passed = false;
+    }
+    
+    // An oversized list range must leave the span untouched
+    Span partial_span(4);
+    partial_span.addNumber(1);
+    try {
+        std::list<int> numbers = {2, 3, 4, 5};
+        partial_span.addNumbers(numbers.begin(), numbers.end());
+        all_passed = false;
+    } catch (const Span::RangeTooBigException& e) {
+        std::cout << "Oversized list range rejected: " << e.what()
+                  << " (size still " << partial_span.size() << ")" << std::endl;
+    }
+    if (partial_span.size() != 1) {
+        all_passed = false;
+    }
+    
+    if (all_passed) {
+        std::cout << GREEN << "✓ Bulk ingestion test passed!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Bulk ingestion test failed" << RESET << std::endl;
+    }
+}
+
+// Test the memory-mapped span: build, reopen, and query the mapped data
+void testMappedSpan() {
+    std::cout << BLUE << "\n=== MEMORY-MAPPED SPAN TEST ===" << RESET << std::endl;
+    
+    const char* path = "mapped_span_test.bin";
+    bool all_passed = true;
+    
+    try {
+        {
+            MappedSpan span(path, 10);
+            span.addNumber(6);
+            span.addNumber(3);
+            std::vector<int> rest = {17, 9, 11};
+            span.addNumbers(rest.begin(), rest.end());
+            std::cout << "Created - Size: " << span.size() << ", Shortest: " << span.shortestSpan()
+                      << ", Longest: " << span.longestSpan() << ", Sorted: " << (span.sorted() ? "yes" : "no") << std::endl;
+            if (span.shortestSpan() != 2 || span.longestSpan() != 14 || span.sorted()) {
+                all_passed = false;
+            }
+            span.sort();
+            span.sync();
+        }
+        {
+            // Reopen: header and data are used as they are on disk
+            MappedSpan span(path);
+            std::cout << "Reopened - Size: " << span.size() << "/" << span.maxSize()
+                      << ", Shortest: " << span.shortestSpan() << ", Longest: " << span.longestSpan()
+                      << ", Sorted: " << (span.sorted() ? "yes" : "no") << std::endl;
+            if (span.size() != 5 || span.maxSize() != 10 || !span.sorted()
+                || span.shortestSpan() != 2 || span.longestSpan() != 14) {
+                all_passed = false;
+            }
+            
+            // Appending in order keeps the sorted flag, out of order clears it
+            span.addNumber(18);
+            bool still_sorted = span.sorted();
+            span.addNumber(-2);
+            if (!still_sorted || span.sorted() || span.shortestSpan() != 1 || span.longestSpan() != 20) {
+                all_passed = false;
+            }
+            
+            // Same exceptions as Span
+            std::list<int> too_many = {1, 2, 3, 4};
+            try {
+                span.addNumbers(too_many.begin(), too_many.end());
+                all_passed = false;
+            } catch (const Span::RangeTooBigException& e) {
+                std::cout << "Range past capacity: " << e.what() << std::endl;
+            }
+            if (span.size() != 7) {
+                all_passed = false;
+            }
+            span.addNumbers(too_many.begin(), std::prev(too_many.end()));
+            try {
+                span.addNumber(0);
+                all_passed = false;
+            } catch (const Span::SpanFullException& e) {
+                std::cout << "Full mapped span: " << e.what() << std::endl;
+            }
+        }
+        
+        // Anything that is not a span file is rejected
+        {
+            std::FILE* file = std::fopen(path, "w");
+            std::fputs("definitely not a span", file);
+            std::fclose(file);
+        }
+        try {
+            MappedSpan span(path);
+            all_passed = false;
+        } catch (const std::runtime_error& e) {
+            std::cout << "Invalid file: " << e.what() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cout << RED << "✗ Memory-mapped span error: " << e.what() << RESET << std::endl;
+        all_passed = false;
+    }
+    std::remove(path);
+    
+    if (all_passed) {
+        std::cout << GREEN << "✓ Memory-mapped span test passed!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Memory-mapped span test failed" << RESET << std::endl;
+    }
+}
+
+// Forward iterator over ints whose first dereference parks the calling
+// thread until released, holding an add between reserve and publish
+struct GatedIterator {
+    typedef std::forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const int* pointer;
+    typedef const int& reference;
+
+    const int* current;
+    std::atomic<bool>* parked;
+    std::atomic<bool>* release;
+
+    GatedIterator() : current(NULL), parked(NULL), release(NULL) {}
+    GatedIterator(const int* p, std::atomic<bool>* parkedFlag, std::atomic<bool>* releaseFlag)
+        : current(p), parked(parkedFlag), release(releaseFlag) {}
+
+    reference operator*() const {
+        *parked = true;
+        while (!release->load()) {
+            std::this_thread::yield();
+        }
+        return *current;
+    }
+    GatedIterator& operator++() { ++current; return *this; }
+    GatedIterator operator++(int) { GatedIterator old(*this); ++current; return old; }
+    bool operator==(const GatedIterator& other) const { return current == other.current; }
+    bool operator!=(const GatedIterator& other) const { return current != other.current; }
+};
+
+// Stress the concurrent span with many producers racing past capacity
+void testConcurrentSpan() {
+    std::cout << BLUE << "\n=== CONCURRENT SPAN STRESS TEST ===" << RESET << std::endl;
+    
+    const unsigned int CAPACITY = 100000;
+    const unsigned int THREADS = 8;
+    const unsigned int PER_THREAD = 20000;  // 160,000 attempts for 100,000 slots
+    bool all_passed = true;
+    
+    for (int round = 0; round < 3; ++round) {
+        ConcurrentSpan span(CAPACITY);
+        std::atomic<unsigned int> accepted(0);
+        std::atomic<unsigned int> rejected(0);
+        
+        std::vector<std::thread> producers;
+        for (unsigned int t = 0; t < THREADS; ++t) {
+            producers.push_back(std::thread([&span, &accepted, &rejected, t, PER_THREAD]() {
+                unsigned int i = 0;
+                while (i < PER_THREAD) {
+                    int value = static_cast<int>((t * PER_THREAD + i) * 7);
+                    // Odd threads mix in small batches
+                    if (t % 2 == 1 && i + 4 <= PER_THREAD) {
+                        int batch[4] = { value, value + 7, value + 14, value + 21 };
+                        try {
+                            span.addNumbers(batch, 4);
+                            accepted += 4;
+                        } catch (const Span::RangeTooBigException&) {
+                            rejected += 4;
+                        }
+                        i += 4;
+                    } else {
+                        try {
+                            span.addNumber(value);
+                            ++accepted;
+                        } catch (const Span::SpanFullException&) {
+                            ++rejected;
+                        }
+                        ++i;
+                    }
+                }
+            }));
+        }
+        for (size_t t = 0; t < producers.size(); ++t) {
+            producers[t].join();
+        }
+        
+        // Capacity is honoured exactly; values are distinct multiples of 7
+        if (accepted != span.size() || accepted + rejected != THREADS * PER_THREAD
+            || span.shortestSpan() != 7) {
+            all_passed = false;
+        }
+        if (round == 0) {
+            std::cout << "Accepted: " << accepted << ", rejected: " << rejected
+                      << ", size: " << span.size() << "/" << span.maxSize()
+                      << ", longest span: " << span.longestSpan() << std::endl;
+        }
+    }
+    
+    // Exactly-at-capacity with single adds only
+    ConcurrentSpan exact(1000);
+    std::atomic<unsigned int> exact_accepted(0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.push_back(std::thread([&exact, &exact_accepted, t]() {
+            for (int i = 0; i < 500; ++i) {
+                try {
+                    exact.addNumber(t * 1000 + i);
+                    ++exact_accepted;
+                } catch (const Span::SpanFullException&) {
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < producers.size(); ++t) {
+        producers[t].join();
+    }
+    if (exact_accepted != 1000 || !exact.full() || exact.size() != 1000) {
+        all_passed = false;
+    }
+    
+    // A writer parked between reserve and publish while other adds commit:
+    // shortestSpan must keep waiting rather than let a later commit stand
+    // in for the parked slot (which still holds the 0 from construction)
+    {
+        ConcurrentSpan span(100000);
+        span.addNumber(3);
+        std::atomic<bool> parked(false);
+        std::atomic<bool> release(false);
+        std::atomic<bool> reader_done(false);
+        std::atomic<unsigned int> reader_result(0);
+        int held_value = 50;
+        GatedIterator held_begin(&held_value, &parked, &release);
+        GatedIterator held_end(&held_value + 1, &parked, &release);
+
+        std::thread writer([&span, held_begin, held_end]() {
+            span.addNumbers(held_begin, held_end);
+        });
+        while (!parked.load()) {
+            std::this_thread::yield();
+        }
+        std::thread reader([&span, &reader_done, &reader_result]() {
+            reader_result = span.shortestSpan();
+            reader_done = true;
+        });
+        std::vector<std::thread> adders;
+        for (int t = 0; t < 4; ++t) {
+            adders.push_back(std::thread([&span, t]() {
+                for (int i = 0; i < 20000; ++i) {
+                    span.addNumber(100 + (t * 20000 + i) * 10);
+                }
+            }));
+        }
+        for (size_t t = 0; t < adders.size(); ++t) {
+            adders[t].join();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (reader_done.load()) {
+            all_passed = false;
+        }
+        release = true;
+        writer.join();
+        reader.join();
+        // 3, 50, 100, 110, ...: shortest gap is 10 (a stray 0 would give 3)
+        if (reader_result != 10 || span.size() != 80002) {
+            all_passed = false;
+        }
+    }
+    
+    if (all_passed) {
+        std::cout << GREEN << "✓ Concurrent span stress test passed!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Concurrent span stress test failed" << RESET << std::endl;
+    }
+}
+
+// Test the sliding window against a brute-force recomputation
+void testWindowedSpan() {
+    std::cout << BLUE << "\n=== SLIDING WINDOW SPAN TEST ===" << RESET << std::endl;
+    
+    bool all_match = true;
+    std::mt19937 gen(5);
+    std::uniform_int_distribution<> dis(-50, 50);  // Narrow range: plenty of duplicates
+    
+    const unsigned int WINDOW_SIZES[] = { 2, 3, 17, 64 };
+    for (int w = 0; w < 4; ++w) {
+        WindowedSpan window(WINDOW_SIZES[w]);
+        std::deque<int> reference;
+        for (int i = 0; i < 3000; ++i) {
+            int value = dis(gen);
+            window.addNumber(value);
+            reference.push_back(value);
+            if (reference.size() > WINDOW_SIZES[w]) {
+                reference.pop_front();
+            }
+            if (reference.size() < 2) {
+                continue;
+            }
+            
+            std::vector<int> sorted_copy(reference.begin(), reference.end());
+            std::sort(sorted_copy.begin(), sorted_copy.end());
+            unsigned int shortest = std::numeric_limits<unsigned int>::max();
+            for (size_t j = 1; j < sorted_copy.size(); ++j) {
+                shortest = std::min(shortest, static_cast<unsigned int>(sorted_copy[j] - sorted_copy[j - 1]));
+            }
+            unsigned int longest = static_cast<unsigned int>(sorted_copy.back() - sorted_copy.front());
+            if (window.shortestSpan() != shortest || window.longestSpan() != longest
+                || window.size() != reference.size()) {
+                all_match = false;
+            }
+        }
+    }
+    
+    // Telemetry-style use: only the last 3 samples count
+    WindowedSpan recent(3);
+    std::vector<int> samples = {100, 1, 50, 52, 60};
+    recent.addNumbers(samples.begin(), samples.end());
+    std::cout << "Last 3 of {100, 1, 50, 52, 60} - Shortest: " << recent.shortestSpan()
+              << ", Longest: " << recent.longestSpan() << ", Full: " << (recent.full() ? "yes" : "no") << std::endl;
+    if (recent.shortestSpan() != 2 || recent.longestSpan() != 10) {
+        all_match = false;
+    }
+    
+    if (all_match) {
+        std::cout << GREEN << "✓ Sliding window matches brute force!" << RESET << std::endl;
+    } else {
+        std::cout << RED << "✗ Sliding window diverged from brute force" << RESET << std::endl;
+    }
+}
+
 // Test large dataset (10,000+ numbers)
 void testLargeDataset() {
     std::cout << BLUE << "\n=== LARGE DATASET TEST (10,000 numbers) ===" << RESET << std::endl;
@@ -259,6 +956,15 @@ int main() {
     testEdgeCases();
     testRangeAddition();
     testCopyAndAssignment();
+    testIncrementalShortestSpan();
+    testRunningExtremes();
+    testScanKernels();
+    testParallelExecution();
+    testSortStrategies();
+    testBulkIngestion();
+    testMappedSpan();
+    testConcurrentSpan();
+    testWindowedSpan();
     testLargeDataset();
     testVeryLargeDataset();
     
@@ -266,5 +972,12 @@ int main() {
     std::cout << CYAN << "           ALL TESTS COMPLETED            " << RESET << std::endl;
     std::cout << CYAN << "===========================================" << RESET << std::endl;
     
+#ifdef CPP08_INSTRUMENT
+    // Built with make INSTRUMENT=1: write out what the hooks recorded
+    instrument::dump("span_stats.json");
+    instrument::dump("span_stats.prom", instrument::PROMETHEUS);
+    std::cout << "Instrumentation written to span_stats.json and span_stats.prom" << std::endl;
+#endif
+    
     return 0;
 }
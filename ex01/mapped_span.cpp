@@ -0,0 +1,216 @@
+#include "mapped_span.hpp"
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char MAGIC[8] = { 'C', 'P', 'P', 'S', 'P', 'A', 'N', '\0' };
+
+static std::runtime_error fileError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+// Create (or truncate) a span file
+MappedSpan::MappedSpan(const std::string& path, unsigned int N)
+    : _path(path), _fd(-1), _mapping(NULL), _mappingSize(0), _header(NULL), _data(NULL) {
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (_fd < 0) {
+        throw fileError("Cannot create span file", path);
+    }
+
+    size_t bytes = sizeof(Header) + static_cast<size_t>(N) * sizeof(int32_t);
+    if (::ftruncate(_fd, static_cast<off_t>(bytes)) != 0) {
+        ::close(_fd);
+        throw fileError("Cannot size span file", path);
+    }
+    map(bytes);
+
+    std::memcpy(_header->magic, MAGIC, sizeof(MAGIC));
+    _header->version = FORMAT_VERSION;
+    _header->capacity = N;
+    _header->size = 0;
+    _header->min = 0;
+    _header->max = 0;
+    _header->flags = FLAG_SORTED;  // The empty sequence is sorted
+}
+
+// Open an existing span file: validate the header and map it, nothing else
+MappedSpan::MappedSpan(const std::string& path)
+    : _path(path), _fd(-1), _mapping(NULL), _mappingSize(0), _header(NULL), _data(NULL) {
+    _fd = ::open(path.c_str(), O_RDWR);
+    if (_fd < 0) {
+        throw fileError("Cannot open span file", path);
+    }
+
+    struct stat info;
+    if (::fstat(_fd, &info) != 0) {
+        ::close(_fd);
+        throw fileError("Cannot stat span file", path);
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    if (bytes < sizeof(Header)) {
+        ::close(_fd);
+        throw std::runtime_error("Not a span file: '" + path + "'");
+    }
+    map(bytes);
+
+    if (std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || _header->version != FORMAT_VERSION
+        || bytes < sizeof(Header) + static_cast<size_t>(_header->capacity) * sizeof(int32_t)
+        || _header->size > _header->capacity) {
+        unmap();
+        throw std::runtime_error("Not a span file (or unsupported version): '" + path + "'");
+    }
+}
+
+// Destructor (writes are already in the shared mapping)
+MappedSpan::~MappedSpan() {
+    unmap();
+}
+
+void MappedSpan::map(size_t bytes) {
+    void* mapping = ::mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (mapping == MAP_FAILED) {
+        ::close(_fd);
+        _fd = -1;
+        throw fileError("Cannot map span file", _path);
+    }
+    _mapping = mapping;
+    _mappingSize = bytes;
+    _header = static_cast<Header*>(mapping);
+    _data = reinterpret_cast<int32_t*>(static_cast<char*>(mapping) + sizeof(Header));
+}
+
+void MappedSpan::unmap() {
+    if (_mapping != NULL) {
+        ::munmap(_mapping, _mappingSize);
+        _mapping = NULL;
+        _header = NULL;
+        _data = NULL;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+// Publish the values written at [first_new, new_size): update the
+// extremes and sorted flag, then the size
+void MappedSpan::commit(uint32_t first_new, uint32_t new_size) {
+    if (new_size == first_new) {
+        return;
+    }
+
+    int block_min, block_max;
+    spanMinMax(_data + first_new, new_size - first_new, block_min, block_max);
+    if (first_new == 0) {
+        _header->min = block_min;
+        _header->max = block_max;
+    } else {
+        if (block_min < _header->min) {
+            _header->min = block_min;
+        }
+        if (block_max > _header->max) {
+            _header->max = block_max;
+        }
+    }
+
+    if (_header->flags & FLAG_SORTED) {
+        uint32_t i = first_new == 0 ? 1 : first_new;
+        for (; i < new_size; ++i) {
+            if (_data[i] < _data[i - 1]) {
+                _header->flags &= ~FLAG_SORTED;
+                break;
+            }
+        }
+    }
+
+    _header->size = new_size;
+}
+
+// Add a single number
+void MappedSpan::addNumber(int number) {
+    if (_header->size >= _header->capacity) {
+        throw Span::SpanFullException();
+    }
+    uint32_t first_new = _header->size;
+    _data[first_new] = number;
+    commit(first_new, first_new + 1);
+}
+
+// Add a contiguous batch with one capacity check and one block copy
+void MappedSpan::addNumbers(const int* numbers, size_t count) {
+    if (count > _header->capacity - _header->size) {
+        throw Span::RangeTooBigException();
+    }
+    uint32_t first_new = _header->size;
+    std::memcpy(_data + first_new, numbers, count * sizeof(int32_t));
+    commit(first_new, first_new + static_cast<uint32_t>(count));
+}
+
+// Sorted data is scanned in place; otherwise a sorted copy is scanned
+unsigned int MappedSpan::shortestSpan() const {
+    if (_header->size < 2) {
+        throw Span::NoSpanException();
+    }
+
+    if (_header->flags & FLAG_SORTED) {
+        return spanMinAdjacentGap(_data, _header->size);
+    }
+
+    _sortBuffer.assign(_data, _data + _header->size);
+    _sortScratch.resize(_sortBuffer.size());
+    spanSort(_sortBuffer.data(), _sortBuffer.size(), SPAN_SORT_AUTO, _sortScratch.data());
+    return spanMinAdjacentGap(_sortBuffer.data(), _sortBuffer.size());
+}
+
+// Extremes are kept in the header
+unsigned int MappedSpan::longestSpan() const {
+    if (_header->size < 2) {
+        throw Span::NoSpanException();
+    }
+    return static_cast<unsigned int>(_header->max) - static_cast<unsigned int>(_header->min);
+}
+
+void MappedSpan::sort() {
+    if (_header->flags & FLAG_SORTED) {
+        return;
+    }
+    _sortScratch.resize(_header->size);
+    spanSort(_data, _header->size, SPAN_SORT_AUTO, _sortScratch.data());
+    _header->flags |= FLAG_SORTED;
+}
+
+bool MappedSpan::sorted() const {
+    return (_header->flags & FLAG_SORTED) != 0;
+}
+
+void MappedSpan::sync() {
+    if (::msync(_mapping, _mappingSize, MS_SYNC) != 0) {
+        throw fileError("Cannot sync span file", _path);
+    }
+}
+
+// Utility functions
+unsigned int MappedSpan::size() const {
+    return _header->size;
+}
+
+unsigned int MappedSpan::maxSize() const {
+    return _header->capacity;
+}
+
+bool MappedSpan::empty() const {
+    return _header->size == 0;
+}
+
+bool MappedSpan::full() const {
+    return _header->size >= _header->capacity;
+}
+
+const std::string& MappedSpan::path() const {
+    return _path;
+}
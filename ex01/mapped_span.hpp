@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <stdint.h>
+#include "span.hpp"
+
+/**
+ * MappedSpan - a Span whose storage is a memory-mapped file
+ *
+ * Opening an existing file maps it and is immediately usable: there is no
+ * parse step. The public interface and exceptions are the same as Span's.
+ *
+ * File format (native byte order, 32-byte header followed by the data):
+ *
+ *   offset  size  field
+ *        0     8  magic "CPPSPAN\0"
+ *        8     4  uint32 format version (1)
+ *       12     4  uint32 capacity (maximum number of values)
+ *       16     4  uint32 size (number of stored values)
+ *       20     4  int32  smallest stored value (valid when size > 0)
+ *       24     4  int32  largest stored value (valid when size > 0)
+ *       28     4  uint32 flags, bit 0 = data is sorted ascending
+ *       32   4*N  int32  data[capacity], the first size entries are used
+ */
+class MappedSpan {
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t size;
+        int32_t min;
+        int32_t max;
+        uint32_t flags;
+    };
+
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t FLAG_SORTED = 1u;
+
+    std::string _path;
+    int _fd;
+    void* _mapping;
+    size_t _mappingSize;
+    Header* _header;
+    int32_t* _data;
+
+    // Scratch for shortestSpan on unsorted data, kept across calls
+    mutable std::vector<int> _sortBuffer;
+    mutable std::vector<int> _sortScratch;
+
+    void map(size_t bytes);
+    void unmap();
+    void commit(uint32_t first_new, uint32_t new_size);
+
+    // A mapping has a single owner
+    MappedSpan(const MappedSpan& other);
+    MappedSpan& operator=(const MappedSpan& other);
+
+public:
+    // Create (or truncate) path as an empty span of capacity N
+    MappedSpan(const std::string& path, unsigned int N);
+
+    // Open an existing span file
+    explicit MappedSpan(const std::string& path);
+
+    // Destructor (unmaps; call sync() first for durability)
+    ~MappedSpan();
+
+    // Member functions
+    void addNumber(int number);
+
+    template<typename Iterator>
+    void addNumbers(Iterator begin, Iterator end);
+
+    void addNumbers(const int* numbers, size_t count);
+
+    unsigned int shortestSpan() const;
+    unsigned int longestSpan() const;
+
+    // Sort the stored values in place so later shortestSpan calls, in this
+    // process or after reopening, scan the mapped data directly
+    void sort();
+    bool sorted() const;
+
+    // Flush the mapping to disk
+    void sync();
+
+    // Utility functions
+    unsigned int size() const;
+    unsigned int maxSize() const;
+    bool empty() const;
+    bool full() const;
+    const std::string& path() const;
+};
+
+// Template function implementation (must be in header)
+template<typename Iterator>
+void MappedSpan::addNumbers(Iterator begin, Iterator end) {
+    if constexpr (std::contiguous_iterator<Iterator>
+                  && std::is_same_v<std::iter_value_t<Iterator>, int>) {
+        addNumbers(std::to_address(begin), static_cast<size_t>(end - begin));
+    } else {
+        // Values are written past the committed size and only become part
+        // of the span once the whole range fits
+        uint32_t first_new = _header->size;
+        uint32_t next = first_new;
+        while (begin != end && next < _header->capacity) {
+            _data[next++] = *begin;
+            ++begin;
+        }
+        if (begin != end) {
+            throw Span::RangeTooBigException();
+        }
+        commit(first_new, next);
+    }
+}
@@ -1,12 +1,24 @@
 #include "span.hpp"
+#include "instrument.hpp"
+#include <thread>
+
+// Smallest amount of work worth handing to an extra thread
+static const size_t PARALLEL_CHUNK_MIN = 1 << 16;
 
 // Constructor
-Span::Span(unsigned int N) : _maxSize(N) {
+Span::Span(unsigned int N)
+    : _maxSize(N), _ordered(N), _minGap(std::numeric_limits<unsigned int>::max()),
+      _min(std::numeric_limits<int>::max()), _max(std::numeric_limits<int>::min()),
+      _threads(1), _sortStrategy(SPAN_SORT_AUTO) {
     _numbers.reserve(N);  // Reserve space for efficiency
 }
 
 // Copy constructor
-Span::Span(const Span& other) : _numbers(other._numbers), _maxSize(other._maxSize) {
+Span::Span(const Span& other)
+    : _numbers(other._numbers), _maxSize(other._maxSize),
+      _ordered(other._ordered), _minGap(other._minGap),
+      _min(other._min), _max(other._max), _threads(other._threads),
+      _sortStrategy(other._sortStrategy) {
 }
 
 // Assignment operator
@@ -14,6 +26,12 @@ Span& Span::operator=(const Span& other) {
     if (this != &other) {
         _numbers = other._numbers;
         _maxSize = other._maxSize;
+        _ordered = other._ordered;
+        _minGap = other._minGap;
+        _min = other._min;
+        _max = other._max;
+        _threads = other._threads;
+        _sortStrategy = other._sortStrategy;
     }
     return *this;
 }
@@ -23,46 +41,155 @@ Span::~Span() {}
 
 // Add a single number
 void Span::addNumber(int number) {
+    CPP08_TIME(SPAN_ADD_NUMBER);
     if (_numbers.size() >= _maxSize) {
         throw SpanFullException();
     }
     _numbers.push_back(number);
+    if (number < _min) {
+        _min = number;
+    }
+    if (number > _max) {
+        _max = number;
+    }
+    indexNumber(number);
+}
+
+// Add a contiguous batch: one capacity check and one block copy
+void Span::addNumbers(const int* numbers, size_t count) {
+    if (count > _maxSize - _numbers.size()) {
+        throw RangeTooBigException();
+    }
+    
+    size_t first_new = _numbers.size();
+    _numbers.insert(_numbers.end(), numbers, numbers + count);
+    absorbNumbers(first_new);
+}
+
+// Fold the values stored from first_new onwards into the running extremes
+// (one fused min/max pass) and the ordered index
+void Span::absorbNumbers(size_t first_new) {
+    size_t added = _numbers.size() - first_new;
+    if (added == 0) {
+        return;
+    }
+
+    int block_min, block_max;
+    spanParallelMinMax(&_numbers[first_new], added, workersFor(added), block_min, block_max);
+    if (block_min < _min) {
+        _min = block_min;
+    }
+    if (block_max > _max) {
+        _max = block_max;
+    }
+
+    // A batch at least as large as the existing index is cheaper to absorb
+    // with one sort and an adjacent-gap scan than with per-value inserts
+    if (added >= _ordered.size() && added >= 64) {
+        rebuildIndex();
+        return;
+    }
+    for (size_t i = first_new; i < _numbers.size(); ++i) {
+        indexNumber(_numbers[i]);
+    }
+}
+
+// Insert a value into the ordered index and update the smallest gap.
+// A new value only creates gaps to its immediate neighbours, and both are
+// no larger than the gap they split, so the minimum can only shrink.
+void Span::indexNumber(int number) {
+    if (_minGap == 0) {
+        return;
+    }
+
+    unsigned int gap;
+    _ordered.insert(number, gap);
+    if (gap < _minGap) {
+        _minGap = gap;
+        if (_minGap == 0) {
+            releaseIndex();  // Duplicate value
+        }
+    }
+}
+
+// Rebuild the ordered index and the smallest gap from all stored values
+void Span::rebuildIndex() {
+    if (_minGap == 0) {
+        return;
+    }
+
+    _sortBuffer.assign(_numbers.begin(), _numbers.end());
+    _sortScratch.resize(_sortBuffer.size());
+    unsigned int workers = workersFor(_sortBuffer.size());
+    spanParallelSort(_sortBuffer.data(), _sortBuffer.size(), workers, _sortStrategy, _sortScratch.data());
+    if (_sortBuffer.size() >= 2) {
+        _minGap = spanParallelMinAdjacentGap(_sortBuffer.data(), _sortBuffer.size(), workers);
+    }
+
+    if (_minGap == 0) {
+        releaseIndex();
+        return;
+    }
+    // Sorted and distinct: the tree is bulk-loaded in linear time
+    _ordered.assignSorted(_sortBuffer.data(), _sortBuffer.size());
+}
+
+// With a duplicate stored the shortest span stays 0, so the index is no
+// longer needed
+void Span::releaseIndex() {
+    _ordered.release();
 }
 
 // Find the shortest span between any two numbers
 unsigned int Span::shortestSpan() const {
+    CPP08_TIME(SPAN_SHORTEST_SPAN);
     if (_numbers.size() < 2) {
         throw NoSpanException();
     }
-    
-    // Create a sorted copy to find minimum adjacent differences
-    std::vector<int> sorted_numbers = _numbers;
-    std::sort(sorted_numbers.begin(), sorted_numbers.end());
-    
-    unsigned int min_span = static_cast<unsigned int>(sorted_numbers[1] - sorted_numbers[0]);
-    
-    // Check all adjacent pairs in sorted array
-    for (size_t i = 1; i < sorted_numbers.size(); ++i) {
-        unsigned int current_span = static_cast<unsigned int>(sorted_numbers[i] - sorted_numbers[i - 1]);
-        if (current_span < min_span) {
-            min_span = current_span;
-        }
-    }
-    
-    return min_span;
+
+    // Maintained incrementally by indexNumber()
+    return _minGap;
 }
 
 // Find the longest span between any two numbers
 unsigned int Span::longestSpan() const {
+    CPP08_TIME(SPAN_LONGEST_SPAN);
     if (_numbers.size() < 2) {
         throw NoSpanException();
     }
     
-    // Find min and max elements
-    std::vector<int>::const_iterator min_it = std::min_element(_numbers.begin(), _numbers.end());
-    std::vector<int>::const_iterator max_it = std::max_element(_numbers.begin(), _numbers.end());
-    
-    return static_cast<unsigned int>(*max_it - *min_it);
+    // Extremes are tracked by addNumber/addNumbers
+    return static_cast<unsigned int>(_max) - static_cast<unsigned int>(_min);
+}
+
+// Parallel execution settings
+void Span::setThreads(unsigned int threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    _threads = threads == 0 ? 1 : threads;
+}
+
+unsigned int Span::threads() const {
+    return _threads;
+}
+
+void Span::setSortStrategy(SpanSortStrategy strategy) {
+    _sortStrategy = strategy;
+}
+
+SpanSortStrategy Span::sortStrategy() const {
+    return _sortStrategy;
+}
+
+// Threads to use for count values: only split when every worker gets a
+// meaningful chunk, so small batches stay on the serial path
+unsigned int Span::workersFor(size_t count) const {
+    size_t workers = count / PARALLEL_CHUNK_MIN;
+    if (workers > _threads) {
+        workers = _threads;
+    }
+    return workers == 0 ? 1 : static_cast<unsigned int>(workers);
 }
 
 // Utility functions
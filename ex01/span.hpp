@@ -1,15 +1,58 @@
 #pragma once 
 
 #include <vector>
+#include <limits>
 #include <algorithm>
 #include <stdexcept>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include "span_kernels.hpp"
+#include "span_index.hpp"
 
+/**
+ * Span - N integers with O(1) shortestSpan and longestSpan
+ *
+ * Every add updates the running min/max and a B+ tree of the values
+ * (SpanIndex), which reports each new value's gap to its neighbours in
+ * O(log n), so the smallest gap is always current. The tree's node pools
+ * are reserved by the constructor along with the values, so adds never
+ * allocate. A batch at least as large as the index is sorted as a whole
+ * instead (radix sort, parallel when enabled) and bulk-loaded.
+ *
+ * Memory: 4 bytes per value for the values plus at most about 8.5 for the
+ * index (about 4.3 after a bulk load). The index is released as soon as a
+ * duplicate makes the shortest span 0.
+ */
 class Span {
 private:
     std::vector<int> _numbers;
     unsigned int _maxSize;
 
+    // Ordered index of the stored values, kept up to date on every insert
+    // so that the smallest neighbour gap never has to be recomputed
+    SpanIndex _ordered;
+    unsigned int _minGap;
+
+    // Running extremes, so longestSpan never has to scan
+    int _min;
+    int _max;
+
+    // Worker threads for bulk scans and index rebuilds (1 = serial)
+    unsigned int _threads;
+
+    // Sort backend for index rebuilds, with buffers kept across rebuilds
+    // so repeated rebuilds do not reallocate
+    SpanSortStrategy _sortStrategy;
+    std::vector<int> _sortBuffer;
+    std::vector<int> _sortScratch;
+
+    void indexNumber(int number);
+    void rebuildIndex();
+    void releaseIndex();
+    void absorbNumbers(size_t first_new);
+    unsigned int workersFor(size_t count) const;
+
 public:
     // Constructor
     explicit Span(unsigned int N);
@@ -30,9 +73,20 @@ public:
     template<typename Iterator>
     void addNumbers(Iterator begin, Iterator end);
     
+    // Bulk addition of a contiguous batch (e.g. a buffer read from a socket)
+    void addNumbers(const int* numbers, size_t count);
+    
     unsigned int shortestSpan() const;
     unsigned int longestSpan() const;
     
+    // Opt-in parallelism for large batches (0 = all hardware threads)
+    void setThreads(unsigned int threads);
+    unsigned int threads() const;
+    
+    // Sort backend used when rebuilding the ordered index
+    void setSortStrategy(SpanSortStrategy strategy);
+    SpanSortStrategy sortStrategy() const;
+    
     // Utility functions
     unsigned int size() const;
     unsigned int maxSize() const;
@@ -59,14 +113,33 @@ public:
 // Template function implementation (must be in header)
 template<typename Iterator>
 void Span::addNumbers(Iterator begin, Iterator end) {
-    // Calculate the distance between iterators
-    size_t distance = std::distance(begin, end);
+    typedef typename std::iterator_traits<Iterator>::iterator_category category;
     
-    // Check if adding this range would exceed capacity
-    if (_numbers.size() + distance > _maxSize) {
-        throw RangeTooBigException();
+    if constexpr (std::contiguous_iterator<Iterator>
+                  && std::is_same_v<std::iter_value_t<Iterator>, int>) {
+        // Contiguous ints: one capacity check and one block copy
+        addNumbers(std::to_address(begin), static_cast<size_t>(end - begin));
+    } else if constexpr (std::is_base_of_v<std::random_access_iterator_tag, category>) {
+        // Distance is O(1): check capacity once, then insert
+        size_t distance = std::distance(begin, end);
+        if (_numbers.size() + distance > _maxSize) {
+            throw RangeTooBigException();
+        }
+        size_t first_new = _numbers.size();
+        _numbers.insert(_numbers.end(), begin, end);
+        absorbNumbers(first_new);
+    } else {
+        // Walk the range once, stopping at capacity; if values remain the
+        // whole range is rolled back so a failed add leaves the span unchanged
+        size_t first_new = _numbers.size();
+        while (begin != end && _numbers.size() < _maxSize) {
+            _numbers.push_back(*begin);
+            ++begin;
+        }
+        if (begin != end) {
+            _numbers.resize(first_new);
+            throw RangeTooBigException();
+        }
+        absorbNumbers(first_new);
     }
-    
-    // Add all numbers from the range
-    _numbers.insert(_numbers.end(), begin, end);
 }
@@ -0,0 +1,253 @@
+#include "span_index.hpp"
+#include <algorithm>
+#include <limits>
+
+// Constructor
+SpanIndex::SpanIndex(size_t capacity)
+    : _root(NIL), _height(0), _size(0), _capacity(capacity) {
+    reservePools();
+}
+
+// Copy constructor: the copy gets its own full-size pools
+SpanIndex::SpanIndex(const SpanIndex& other)
+    : _root(other._root), _height(other._height), _size(other._size), _capacity(other._capacity) {
+    reservePools();
+    _leaves.assign(other._leaves.begin(), other._leaves.end());
+    _inners.assign(other._inners.begin(), other._inners.end());
+}
+
+// Assignment operator
+SpanIndex& SpanIndex::operator=(const SpanIndex& other) {
+    if (this != &other) {
+        _root = other._root;
+        _height = other._height;
+        _size = other._size;
+        _capacity = other._capacity;
+        reservePools();
+        _leaves.assign(other._leaves.begin(), other._leaves.end());
+        _inners.assign(other._inners.begin(), other._inners.end());
+    }
+    return *this;
+}
+
+// Destructor
+SpanIndex::~SpanIndex() {}
+
+// Leaves split into halves, so capacity values never need more than
+// capacity / (LEAF_CAPACITY / 2) leaves; inner nodes likewise hold at
+// least FANOUT / 2 children, plus one partly filled node per level
+void SpanIndex::reservePools() {
+    size_t leaves = _capacity / (LEAF_CAPACITY / 2) + 2;
+    _leaves.reserve(leaves);
+    _inners.reserve(leaves / (FANOUT / 2) + 2 * MAX_HEIGHT);
+}
+
+std::uint32_t SpanIndex::newLeaf() {
+    Leaf leaf;
+    leaf.count = 0;
+    leaf.prev = NIL;
+    leaf.next = NIL;
+    _leaves.push_back(leaf);
+    return static_cast<std::uint32_t>(_leaves.size() - 1);
+}
+
+bool SpanIndex::insert(int value, unsigned int& gap) {
+    gap = std::numeric_limits<unsigned int>::max();
+    if (_root == NIL) {
+        _root = newLeaf();
+        _height = 0;
+    }
+
+    // Descend, remembering the way back up for splits
+    std::uint32_t path[MAX_HEIGHT];
+    unsigned int positions[MAX_HEIGHT];
+    std::uint32_t node = _root;
+    for (unsigned int level = 0; level < _height; ++level) {
+        const Inner& inner = _inners[node];
+        unsigned int child = static_cast<unsigned int>(
+            std::upper_bound(inner.keys + 1, inner.keys + inner.count, value) - inner.keys) - 1;
+        path[level] = node;
+        positions[level] = child;
+        node = inner.children[child];
+    }
+
+    Leaf& leaf = _leaves[node];
+    unsigned int at = static_cast<unsigned int>(std::lower_bound(leaf.keys, leaf.keys + leaf.count, value) - leaf.keys);
+    if (at < leaf.count && leaf.keys[at] == value) {
+        gap = 0;
+        return false;
+    }
+
+    // Neighbours: in this leaf, or at the near end of the linked one
+    const int* below = NULL;
+    const int* above = NULL;
+    if (at > 0) {
+        below = &leaf.keys[at - 1];
+    } else if (leaf.prev != NIL) {
+        const Leaf& prev = _leaves[leaf.prev];
+        below = &prev.keys[prev.count - 1];
+    }
+    if (at < leaf.count) {
+        above = &leaf.keys[at];
+    } else if (leaf.next != NIL) {
+        above = &_leaves[leaf.next].keys[0];
+    }
+    if (below != NULL) {
+        gap = std::min(gap, static_cast<unsigned int>(value) - static_cast<unsigned int>(*below));
+    }
+    if (above != NULL) {
+        gap = std::min(gap, static_cast<unsigned int>(*above) - static_cast<unsigned int>(value));
+    }
+
+    ++_size;
+    if (leaf.count < LEAF_CAPACITY) {
+        std::copy_backward(leaf.keys + at, leaf.keys + leaf.count, leaf.keys + leaf.count + 1);
+        leaf.keys[at] = value;
+        ++leaf.count;
+        return true;
+    }
+
+    // Full leaf: move the upper half to a new right sibling
+    std::uint32_t right_index = newLeaf();
+    Leaf& left = _leaves[node];
+    Leaf& right = _leaves[right_index];
+    const unsigned int half = LEAF_CAPACITY / 2;
+    std::copy(left.keys + half, left.keys + LEAF_CAPACITY, right.keys);
+    right.count = LEAF_CAPACITY - half;
+    left.count = half;
+    right.prev = node;
+    right.next = left.next;
+    if (left.next != NIL) {
+        _leaves[left.next].prev = right_index;
+    }
+    left.next = right_index;
+
+    Leaf& target = at <= half ? left : right;
+    unsigned int target_at = at <= half ? at : at - half;
+    std::copy_backward(target.keys + target_at, target.keys + target.count, target.keys + target.count + 1);
+    target.keys[target_at] = value;
+    ++target.count;
+
+    insertIntoParents(path, positions, _height, right.keys[0], right_index);
+    return true;
+}
+
+// Add child (whose smallest key is separator) right after the child the
+// descent took at each level, splitting full inner nodes on the way up
+void SpanIndex::insertIntoParents(const std::uint32_t* path, const unsigned int* positions,
+                                  unsigned int depth, int separator, std::uint32_t child) {
+    while (depth > 0) {
+        --depth;
+        std::uint32_t node = path[depth];
+        unsigned int at = positions[depth] + 1;
+        if (_inners[node].count < FANOUT) {
+            Inner& inner = _inners[node];
+            std::copy_backward(inner.keys + at, inner.keys + inner.count, inner.keys + inner.count + 1);
+            std::copy_backward(inner.children + at, inner.children + inner.count, inner.children + inner.count + 1);
+            inner.keys[at] = separator;
+            inner.children[at] = child;
+            ++inner.count;
+            return;
+        }
+
+        // Full: lay out the FANOUT + 1 entries, then give the upper half to
+        // a new right sibling and pass its smallest key up
+        int keys[FANOUT + 1];
+        std::uint32_t children[FANOUT + 1];
+        const Inner& full = _inners[node];
+        std::copy(full.keys, full.keys + at, keys);
+        std::copy(full.children, full.children + at, children);
+        keys[at] = separator;
+        children[at] = child;
+        std::copy(full.keys + at, full.keys + FANOUT, keys + at + 1);
+        std::copy(full.children + at, full.children + FANOUT, children + at + 1);
+
+        const unsigned int half = (FANOUT + 1) / 2;
+        Inner right;
+        right.count = FANOUT + 1 - half;
+        std::copy(keys + half, keys + FANOUT + 1, right.keys);
+        std::copy(children + half, children + FANOUT + 1, right.children);
+        _inners.push_back(right);
+
+        Inner& left = _inners[node];
+        left.count = half;
+        std::copy(keys, keys + half, left.keys);
+        std::copy(children, children + half, left.children);
+
+        separator = right.keys[0];
+        child = static_cast<std::uint32_t>(_inners.size() - 1);
+    }
+
+    // The root split: grow a level
+    Inner root;
+    root.count = 2;
+    root.keys[0] = separator;
+    root.keys[1] = separator;
+    root.children[0] = _root;
+    root.children[1] = child;
+    _inners.push_back(root);
+    _root = static_cast<std::uint32_t>(_inners.size() - 1);
+    ++_height;
+}
+
+// Fill leaves completely, then build each inner level over the one below
+void SpanIndex::assignSorted(const int* sorted, size_t count) {
+    _leaves.clear();
+    _inners.clear();
+    _root = NIL;
+    _height = 0;
+    _size = count;
+    if (_capacity < count) {
+        _capacity = count;
+        reservePools();
+    }
+    if (count == 0) {
+        return;
+    }
+
+    for (size_t first = 0; first < count; first += LEAF_CAPACITY) {
+        std::uint32_t index = newLeaf();
+        Leaf& leaf = _leaves[index];
+        leaf.count = static_cast<std::uint32_t>(std::min<size_t>(LEAF_CAPACITY, count - first));
+        std::copy(sorted + first, sorted + first + leaf.count, leaf.keys);
+        if (index > 0) {
+            leaf.prev = index - 1;
+            _leaves[index - 1].next = index;
+        }
+    }
+
+    std::uint32_t level_first = 0;
+    std::uint32_t level_count = static_cast<std::uint32_t>(_leaves.size());
+    bool below_is_leaves = true;
+    while (level_count > 1) {
+        std::uint32_t next_first = static_cast<std::uint32_t>(_inners.size());
+        for (std::uint32_t first = 0; first < level_count; first += FANOUT) {
+            Inner inner;
+            inner.count = std::min(FANOUT, level_count - first);
+            for (std::uint32_t i = 0; i < inner.count; ++i) {
+                std::uint32_t child = level_first + first + i;
+                inner.children[i] = child;
+                inner.keys[i] = below_is_leaves ? _leaves[child].keys[0] : _inners[child].keys[0];
+            }
+            _inners.push_back(inner);
+        }
+        level_first = next_first;
+        level_count = static_cast<std::uint32_t>(_inners.size()) - next_first;
+        below_is_leaves = false;
+        ++_height;
+    }
+    _root = level_first;
+}
+
+void SpanIndex::release() {
+    std::vector<Leaf>().swap(_leaves);
+    std::vector<Inner>().swap(_inners);
+    _root = NIL;
+    _height = 0;
+    _size = 0;
+    _capacity = 0;
+}
+
+size_t SpanIndex::size() const {
+    return _size;
+}
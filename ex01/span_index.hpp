@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * SpanIndex - Ordered set of distinct ints behind Span::shortestSpan
+ *
+ * A B+ tree whose nodes live in two pools reserved for the capacity given
+ * to the constructor, so an insert never allocates while the index holds
+ * at most that many values. insert() descends once, O(log n), and reports
+ * the gap from the new value to its neighbours; leaves are linked, so a
+ * neighbour in the adjacent leaf costs one extra read.
+ *
+ * Every leaf except the last one of a level is at least half full, so the
+ * tree takes at most about 8.5 bytes per value (about 4.3 after
+ * assignSorted).
+ */
+class SpanIndex {
+public:
+    static constexpr unsigned int LEAF_CAPACITY = 64;   // Keys per leaf
+    static constexpr unsigned int FANOUT = 32;          // Children per inner node
+
+private:
+    static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+    static constexpr unsigned int MAX_HEIGHT = 32;      // Inner levels; 2^32 values need fewer than 8
+
+    struct Leaf {
+        int keys[LEAF_CAPACITY];
+        std::uint32_t count;
+        std::uint32_t prev;
+        std::uint32_t next;
+    };
+
+    // keys[i] <= every key under children[i] < keys[i + 1]
+    struct Inner {
+        int keys[FANOUT];
+        std::uint32_t children[FANOUT];
+        std::uint32_t count;
+    };
+
+    std::vector<Leaf> _leaves;
+    std::vector<Inner> _inners;
+    std::uint32_t _root;
+    unsigned int _height;   // Inner levels above the leaves
+    size_t _size;
+    size_t _capacity;
+
+    void reservePools();
+    std::uint32_t newLeaf();
+    void insertIntoParents(const std::uint32_t* path, const unsigned int* positions,
+                           unsigned int depth, int separator, std::uint32_t child);
+
+public:
+    // Constructor (reserves node pools for capacity values)
+    explicit SpanIndex(size_t capacity = 0);
+
+    // Copy constructor
+    SpanIndex(const SpanIndex& other);
+
+    // Assignment operator
+    SpanIndex& operator=(const SpanIndex& other);
+
+    // Destructor
+    ~SpanIndex();
+
+    /**
+     * Insert a value
+     * @param value The value to insert
+     * @param gap Receives the smallest distance from value to a stored
+     *            neighbour (0 for a duplicate, UINT_MAX with no neighbour)
+     * @return false if value was already stored (nothing is inserted)
+     */
+    bool insert(int value, unsigned int& gap);
+
+    // Replace the contents with an ascending run of distinct values, O(n)
+    void assignSorted(const int* sorted, size_t count);
+
+    // Drop every value and give the pools back
+    void release();
+
+    size_t size() const;
+};
@@ -0,0 +1,406 @@
+#include "span_kernels.hpp"
+#include <atomic>
+#include <limits>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+# define SPAN_KERNELS_X86 1
+# include <immintrin.h>
+#endif
+
+// Scalar kernels (portable fallback, also used for the tails of SIMD loops)
+static void minMaxScalar(const int* data, size_t count, int& min, int& max) {
+    int lo = data[0];
+    int hi = data[0];
+    for (size_t i = 1; i < count; ++i) {
+        if (data[i] < lo) {
+            lo = data[i];
+        }
+        if (data[i] > hi) {
+            hi = data[i];
+        }
+    }
+    min = lo;
+    max = hi;
+}
+
+static unsigned int minGapScalar(const int* sorted, size_t count) {
+    unsigned int gap = std::numeric_limits<unsigned int>::max();
+    for (size_t i = 1; i < count; ++i) {
+        unsigned int current = static_cast<unsigned int>(sorted[i]) - static_cast<unsigned int>(sorted[i - 1]);
+        if (current < gap) {
+            gap = current;
+        }
+    }
+    return gap;
+}
+
+#ifdef SPAN_KERNELS_X86
+
+// SSE4.1 kernels: 4 lanes
+__attribute__((target("sse4.1")))
+static void minMaxSse41(const int* data, size_t count, int& min, int& max) {
+    if (count < 8) {
+        minMaxScalar(data, count, min, max);
+        return;
+    }
+
+    __m128i vmin0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i vmin1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4));
+    __m128i vmax0 = vmin0;
+    __m128i vmax1 = vmin1;
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 4));
+        vmin0 = _mm_min_epi32(vmin0, v0);
+        vmin1 = _mm_min_epi32(vmin1, v1);
+        vmax0 = _mm_max_epi32(vmax0, v0);
+        vmax1 = _mm_max_epi32(vmax1, v1);
+    }
+
+    alignas(16) int lanes_min[4];
+    alignas(16) int lanes_max[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes_min), _mm_min_epi32(vmin0, vmin1));
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes_max), _mm_max_epi32(vmax0, vmax1));
+    int lo, hi;
+    minMaxScalar(lanes_min, 4, lo, hi);
+    min = lo;
+    minMaxScalar(lanes_max, 4, lo, hi);
+    max = hi;
+
+    for (; i < count; ++i) {
+        if (data[i] < min) {
+            min = data[i];
+        }
+        if (data[i] > max) {
+            max = data[i];
+        }
+    }
+}
+
+__attribute__((target("sse4.1")))
+static unsigned int minGapSse41(const int* sorted, size_t count) {
+    __m128i vgap = _mm_set1_epi32(-1);
+    size_t i = 0;
+    // Each step needs sorted[i + 4], hence the strict bound
+    for (; i + 4 < count; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sorted + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sorted + i + 1));
+        vgap = _mm_min_epu32(vgap, _mm_sub_epi32(b, a));
+    }
+
+    alignas(16) unsigned int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), vgap);
+    unsigned int gap = lanes[0];
+    for (int lane = 1; lane < 4; ++lane) {
+        if (lanes[lane] < gap) {
+            gap = lanes[lane];
+        }
+    }
+
+    unsigned int tail = minGapScalar(sorted + i, count - i);
+    return tail < gap ? tail : gap;
+}
+
+// AVX2 kernels: 8 lanes
+__attribute__((target("avx2")))
+static void minMaxAvx2(const int* data, size_t count, int& min, int& max) {
+    if (count < 16) {
+        minMaxScalar(data, count, min, max);
+        return;
+    }
+
+    __m256i vmin0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    __m256i vmin1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8));
+    __m256i vmax0 = vmin0;
+    __m256i vmax1 = vmin1;
+    size_t i = 16;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+        vmin0 = _mm256_min_epi32(vmin0, v0);
+        vmin1 = _mm256_min_epi32(vmin1, v1);
+        vmax0 = _mm256_max_epi32(vmax0, v0);
+        vmax1 = _mm256_max_epi32(vmax1, v1);
+    }
+
+    alignas(32) int lanes_min[8];
+    alignas(32) int lanes_max[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_min), _mm256_min_epi32(vmin0, vmin1));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_max), _mm256_max_epi32(vmax0, vmax1));
+    int lo, hi;
+    minMaxScalar(lanes_min, 8, lo, hi);
+    min = lo;
+    minMaxScalar(lanes_max, 8, lo, hi);
+    max = hi;
+
+    for (; i < count; ++i) {
+        if (data[i] < min) {
+            min = data[i];
+        }
+        if (data[i] > max) {
+            max = data[i];
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static unsigned int minGapAvx2(const int* sorted, size_t count) {
+    __m256i vgap = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    // Each step needs sorted[i + 8], hence the strict bound
+    for (; i + 8 < count; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sorted + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sorted + i + 1));
+        vgap = _mm256_min_epu32(vgap, _mm256_sub_epi32(b, a));
+    }
+
+    alignas(32) unsigned int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), vgap);
+    unsigned int gap = lanes[0];
+    for (int lane = 1; lane < 8; ++lane) {
+        if (lanes[lane] < gap) {
+            gap = lanes[lane];
+        }
+    }
+
+    unsigned int tail = minGapScalar(sorted + i, count - i);
+    return tail < gap ? tail : gap;
+}
+
+#endif
+
+// Runtime dispatch
+static std::atomic<int> g_isa(-1);
+
+SpanKernelIsa spanKernelBestIsa() {
+#ifdef SPAN_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SPAN_ISA_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SPAN_ISA_SSE41;
+    }
+#endif
+    return SPAN_ISA_SCALAR;
+}
+
+SpanKernelIsa spanKernelIsa() {
+    int isa = g_isa.load(std::memory_order_relaxed);
+    if (isa < 0) {
+        isa = spanKernelBestIsa();
+        g_isa.store(isa, std::memory_order_relaxed);
+    }
+    return static_cast<SpanKernelIsa>(isa);
+}
+
+void setSpanKernelIsa(SpanKernelIsa isa) {
+    SpanKernelIsa best = spanKernelBestIsa();
+    g_isa.store(isa > best ? best : isa, std::memory_order_relaxed);
+}
+
+const char* spanKernelIsaName(SpanKernelIsa isa) {
+    switch (isa) {
+        case SPAN_ISA_AVX2:
+            return "avx2";
+        case SPAN_ISA_SSE41:
+            return "sse4.1";
+        default:
+            return "scalar";
+    }
+}
+
+void spanMinMax(const int* data, size_t count, int& min, int& max) {
+    switch (spanKernelIsa()) {
+#ifdef SPAN_KERNELS_X86
+        case SPAN_ISA_AVX2:
+            minMaxAvx2(data, count, min, max);
+            return;
+        case SPAN_ISA_SSE41:
+            minMaxSse41(data, count, min, max);
+            return;
+#endif
+        default:
+            minMaxScalar(data, count, min, max);
+            return;
+    }
+}
+
+unsigned int spanMinAdjacentGap(const int* sorted, size_t count) {
+    switch (spanKernelIsa()) {
+#ifdef SPAN_KERNELS_X86
+        case SPAN_ISA_AVX2:
+            return minGapAvx2(sorted, count);
+        case SPAN_ISA_SSE41:
+            return minGapSse41(sorted, count);
+#endif
+        default:
+            return minGapScalar(sorted, count);
+    }
+}
+
+// Sort backends
+
+// Signed ints are ordered as unsigned once the sign bit is flipped
+static inline unsigned int radixKey(int value) {
+    return static_cast<unsigned int>(value) ^ 0x80000000u;
+}
+
+void spanRadixSort(int* data, size_t count, int* scratch) {
+    if (count < 2) {
+        return;
+    }
+
+    // One histogram pass for all four digits
+    size_t histogram[4][256];
+    std::memset(histogram, 0, sizeof(histogram));
+    for (size_t i = 0; i < count; ++i) {
+        unsigned int key = radixKey(data[i]);
+        ++histogram[0][key & 0xFF];
+        ++histogram[1][(key >> 8) & 0xFF];
+        ++histogram[2][(key >> 16) & 0xFF];
+        ++histogram[3][key >> 24];
+    }
+
+    int* source = data;
+    int* target = scratch;
+    for (int pass = 0; pass < 4; ++pass) {
+        unsigned int shift = pass * 8;
+        size_t* counts = histogram[pass];
+
+        // Every value has the same digit: this pass would not move anything
+        if (counts[(radixKey(source[0]) >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            size_t digit_count = counts[digit];
+            counts[digit] = offset;
+            offset += digit_count;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            target[counts[(radixKey(source[i]) >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+
+    if (source != data) {
+        std::memcpy(data, source, count * sizeof(int));
+    }
+}
+
+void spanSort(int* data, size_t count, SpanSortStrategy strategy, int* scratch) {
+    if (strategy == SPAN_SORT_RADIX || (strategy == SPAN_SORT_AUTO && count >= SPAN_RADIX_THRESHOLD)) {
+        spanRadixSort(data, count, scratch);
+    } else {
+        std::sort(data, data + count);
+    }
+}
+
+// Parallel variants
+
+// Runs task(index) for index in [0, workers), using the calling thread for
+// the last one
+template<typename Task>
+static void runWorkers(unsigned int workers, Task task) {
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned int i = 0; i + 1 < workers; ++i) {
+        pool.push_back(std::thread(task, i));
+    }
+    task(workers - 1);
+    for (size_t i = 0; i < pool.size(); ++i) {
+        pool[i].join();
+    }
+}
+
+static unsigned int clampWorkers(unsigned int threads, size_t count) {
+    if (threads == 0) {
+        threads = 1;
+    }
+    if (count < threads) {
+        threads = static_cast<unsigned int>(count);
+    }
+    return threads;
+}
+
+// Bounds of chunk index out of workers equal chunks
+static size_t chunkBegin(size_t count, unsigned int workers, unsigned int index) {
+    return count / workers * index + std::min<size_t>(index, count % workers);
+}
+
+void spanParallelMinMax(const int* data, size_t count, unsigned int threads, int& min, int& max) {
+    unsigned int workers = clampWorkers(threads, count);
+    if (workers <= 1) {
+        spanMinMax(data, count, min, max);
+        return;
+    }
+
+    std::vector<int> mins(workers);
+    std::vector<int> maxs(workers);
+    runWorkers(workers, [&](unsigned int index) {
+        size_t begin = chunkBegin(count, workers, index);
+        size_t end = chunkBegin(count, workers, index + 1);
+        spanMinMax(data + begin, end - begin, mins[index], maxs[index]);
+    });
+    min = *std::min_element(mins.begin(), mins.end());
+    max = *std::max_element(maxs.begin(), maxs.end());
+}
+
+unsigned int spanParallelMinAdjacentGap(const int* sorted, size_t count, unsigned int threads) {
+    // Every chunk needs at least one pair
+    unsigned int workers = clampWorkers(threads, count - 1);
+    if (workers <= 1) {
+        return spanMinAdjacentGap(sorted, count);
+    }
+
+    std::vector<unsigned int> gaps(workers);
+    runWorkers(workers, [&](unsigned int index) {
+        // Pairs [begin, end) of the count - 1 adjacent pairs; pair i spans
+        // sorted[i] and sorted[i + 1], so the chunk reads one value past end
+        size_t begin = chunkBegin(count - 1, workers, index);
+        size_t end = chunkBegin(count - 1, workers, index + 1);
+        gaps[index] = spanMinAdjacentGap(sorted + begin, end - begin + 1);
+    });
+    return *std::min_element(gaps.begin(), gaps.end());
+}
+
+void spanParallelSort(int* data, size_t count, unsigned int threads,
+                      SpanSortStrategy strategy, int* scratch) {
+    unsigned int workers = clampWorkers(threads, count);
+    if (workers <= 1) {
+        spanSort(data, count, strategy, scratch);
+        return;
+    }
+
+    // Each chunk uses the matching slice of scratch
+    runWorkers(workers, [&](unsigned int index) {
+        size_t begin = chunkBegin(count, workers, index);
+        size_t end = chunkBegin(count, workers, index + 1);
+        spanSort(data + begin, end - begin, strategy, scratch + begin);
+    });
+
+    // Merge runs of width chunks pairwise until one sorted run remains
+    for (unsigned int width = 1; width < workers; width *= 2) {
+        unsigned int merges = (workers + 2 * width - 1) / (2 * width);
+        runWorkers(merges, [&](unsigned int merge) {
+            unsigned int left = merge * 2 * width;
+            unsigned int middle = std::min(left + width, workers);
+            unsigned int right = std::min(left + 2 * width, workers);
+            if (middle < right) {
+                size_t begin = chunkBegin(count, workers, left);
+                size_t end = chunkBegin(count, workers, right);
+                std::merge(data + begin, data + chunkBegin(count, workers, middle),
+                           data + chunkBegin(count, workers, middle), data + end,
+                           scratch + begin);
+                std::memcpy(data + begin, scratch + begin, (end - begin) * sizeof(int));
+            }
+        });
+    }
+}
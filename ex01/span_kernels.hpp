@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Scan kernels used by Span on contiguous int data.
+ *
+ * Each kernel has a portable scalar version and, on x86, SSE4.1 and AVX2
+ * versions. The widest instruction set supported by the running CPU is
+ * picked on first use.
+ */
+enum SpanKernelIsa {
+    SPAN_ISA_SCALAR,
+    SPAN_ISA_SSE41,
+    SPAN_ISA_AVX2
+};
+
+/**
+ * Single-pass min and max reduction
+ * @param data Pointer to the first value
+ * @param count Number of values, must be at least 1
+ * @param min Receives the smallest value
+ * @param max Receives the largest value
+ */
+void spanMinMax(const int* data, size_t count, int& min, int& max);
+
+/**
+ * Smallest difference between neighbours of an ascending sequence
+ * @param sorted Pointer to the first value of a sorted range
+ * @param count Number of values, must be at least 2
+ * @return The minimum of sorted[i + 1] - sorted[i], computed without overflow
+ */
+unsigned int spanMinAdjacentGap(const int* sorted, size_t count);
+
+// Instruction set currently used by the kernels
+SpanKernelIsa spanKernelIsa();
+
+// Best instruction set supported by this CPU
+SpanKernelIsa spanKernelBestIsa();
+
+// Restrict the kernels to an instruction set (clamped to what the CPU supports)
+void setSpanKernelIsa(SpanKernelIsa isa);
+
+const char* spanKernelIsaName(SpanKernelIsa isa);
+
+/**
+ * Sort backends. SPAN_SORT_AUTO uses the LSD radix sort from
+ * SPAN_RADIX_THRESHOLD values upwards and std::sort below it.
+ */
+enum SpanSortStrategy {
+    SPAN_SORT_AUTO,
+    SPAN_SORT_COMPARISON,
+    SPAN_SORT_RADIX
+};
+
+const size_t SPAN_RADIX_THRESHOLD = 2048;
+
+/**
+ * LSD radix sort, 8 bits per pass, skipping passes where every value
+ * shares the same digit
+ * @param data Values to sort in place
+ * @param count Number of values
+ * @param scratch Caller-owned buffer of at least count ints
+ */
+void spanRadixSort(int* data, size_t count, int* scratch);
+
+// Sort with the given strategy; scratch must hold count ints
+void spanSort(int* data, size_t count, SpanSortStrategy strategy, int* scratch);
+
+/**
+ * Parallel variants. Work is split into one contiguous chunk per thread
+ * (capped by the number of values); with threads <= 1 they run the serial
+ * kernels above and always produce the same results.
+ */
+void spanParallelMinMax(const int* data, size_t count, unsigned int threads, int& min, int& max);
+
+// Chunks overlap by one value so gaps across chunk boundaries are included
+unsigned int spanParallelMinAdjacentGap(const int* sorted, size_t count, unsigned int threads);
+
+// Sorts each chunk concurrently, then merges neighbouring chunks pairwise
+// through scratch (count ints), so no memory is allocated
+void spanParallelSort(int* data, size_t count, unsigned int threads,
+                      SpanSortStrategy strategy, int* scratch);
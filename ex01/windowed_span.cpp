@@ -0,0 +1,141 @@
+#include "windowed_span.hpp"
+
+static unsigned int gapBetween(int low, int high) {
+    return static_cast<unsigned int>(high) - static_cast<unsigned int>(low);
+}
+
+// Constructor
+WindowedSpan::WindowedSpan(unsigned int N) : _windowSize(N) {
+}
+
+// Copy constructor
+WindowedSpan::WindowedSpan(const WindowedSpan& other)
+    : _window(other._window), _minCandidates(other._minCandidates),
+      _maxCandidates(other._maxCandidates), _values(other._values),
+      _gaps(other._gaps), _windowSize(other._windowSize) {
+}
+
+// Assignment operator
+WindowedSpan& WindowedSpan::operator=(const WindowedSpan& other) {
+    if (this != &other) {
+        _window = other._window;
+        _minCandidates = other._minCandidates;
+        _maxCandidates = other._maxCandidates;
+        _values = other._values;
+        _gaps = other._gaps;
+        _windowSize = other._windowSize;
+    }
+    return *this;
+}
+
+// Destructor
+WindowedSpan::~WindowedSpan() {}
+
+// Add a number, evicting the oldest one when the window is full
+void WindowedSpan::addNumber(int number) {
+    if (_windowSize == 0) {
+        throw Span::SpanFullException();
+    }
+    if (_window.size() >= _windowSize) {
+        evictOldest();
+    }
+
+    _window.push_back(number);
+    insertValue(number);
+
+    // A new value outlives every older candidate it beats
+    while (!_minCandidates.empty() && _minCandidates.back() > number) {
+        _minCandidates.pop_back();
+    }
+    _minCandidates.push_back(number);
+    while (!_maxCandidates.empty() && _maxCandidates.back() < number) {
+        _maxCandidates.pop_back();
+    }
+    _maxCandidates.push_back(number);
+}
+
+// The new value splits the gap between its neighbours in two
+void WindowedSpan::insertValue(int number) {
+    std::multiset<int>::iterator it = _values.insert(number);
+    std::multiset<int>::iterator next = it;
+    ++next;
+    bool has_prev = it != _values.begin();
+    bool has_next = next != _values.end();
+
+    if (has_prev) {
+        std::multiset<int>::iterator prev = it;
+        --prev;
+        if (has_next) {
+            _gaps.erase(_gaps.find(gapBetween(*prev, *next)));
+        }
+        _gaps.insert(gapBetween(*prev, number));
+    }
+    if (has_next) {
+        _gaps.insert(gapBetween(number, *next));
+    }
+}
+
+// Removing a value merges its two gaps back into one
+void WindowedSpan::evictOldest() {
+    int number = _window.front();
+    _window.pop_front();
+
+    if (_minCandidates.front() == number) {
+        _minCandidates.pop_front();
+    }
+    if (_maxCandidates.front() == number) {
+        _maxCandidates.pop_front();
+    }
+
+    std::multiset<int>::iterator it = _values.find(number);
+    std::multiset<int>::iterator next = it;
+    ++next;
+    bool has_prev = it != _values.begin();
+    bool has_next = next != _values.end();
+
+    if (has_prev) {
+        std::multiset<int>::iterator prev = it;
+        --prev;
+        _gaps.erase(_gaps.find(gapBetween(*prev, number)));
+        if (has_next) {
+            _gaps.insert(gapBetween(*prev, *next));
+        }
+    }
+    if (has_next) {
+        _gaps.erase(_gaps.find(gapBetween(number, *next)));
+    }
+    _values.erase(it);
+}
+
+// Smallest gap currently in the window
+unsigned int WindowedSpan::shortestSpan() const {
+    if (_window.size() < 2) {
+        throw Span::NoSpanException();
+    }
+    return *_gaps.begin();
+}
+
+// Window maximum minus window minimum
+unsigned int WindowedSpan::longestSpan() const {
+    if (_window.size() < 2) {
+        throw Span::NoSpanException();
+    }
+    return gapBetween(_minCandidates.front(), _maxCandidates.front());
+}
+
+// Utility functions
+unsigned int WindowedSpan::size() const {
+    return static_cast<unsigned int>(_window.size());
+}
+
+unsigned int WindowedSpan::maxSize() const {
+    return _windowSize;
+}
+
+bool WindowedSpan::empty() const {
+    return _window.empty();
+}
+
+bool WindowedSpan::full() const {
+    return _window.size() >= _windowSize;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <deque>
+#include <set>
+#include "span.hpp"
+
+/**
+ * WindowedSpan - shortest/longest span over the last N values
+ *
+ * Instead of throwing once full, adding a value evicts the oldest one.
+ * Longest span comes from two monotonic deques (candidates for the window
+ * minimum and maximum); shortest span from an ordered multiset of the
+ * gaps between neighbouring values. Each add costs O(log N), and both
+ * queries are O(1).
+ */
+class WindowedSpan {
+private:
+    std::deque<int> _window;         // Values in arrival order, oldest first
+    std::deque<int> _minCandidates;  // Non-decreasing, front is the minimum
+    std::deque<int> _maxCandidates;  // Non-increasing, front is the maximum
+    std::multiset<int> _values;      // Window values in order
+    std::multiset<unsigned int> _gaps;  // Gaps between neighbours in _values
+    unsigned int _windowSize;
+
+    void insertValue(int number);
+    void evictOldest();
+
+public:
+    // Constructor
+    explicit WindowedSpan(unsigned int N);
+
+    // Copy constructor
+    WindowedSpan(const WindowedSpan& other);
+
+    // Assignment operator
+    WindowedSpan& operator=(const WindowedSpan& other);
+
+    // Destructor
+    ~WindowedSpan();
+
+    // Member functions (never full: the oldest value makes room)
+    void addNumber(int number);
+
+    template<typename Iterator>
+    void addNumbers(Iterator begin, Iterator end);
+
+    unsigned int shortestSpan() const;
+    unsigned int longestSpan() const;
+
+    // Utility functions
+    unsigned int size() const;
+    unsigned int maxSize() const;
+    bool empty() const;
+    bool full() const;
+};
+
+// Template function implementation (must be in header)
+template<typename Iterator>
+void WindowedSpan::addNumbers(Iterator begin, Iterator end) {
+    for (; begin != end; ++begin) {
+        addNumber(*begin);
+    }
+}
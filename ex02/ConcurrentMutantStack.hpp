@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * ConcurrentMutantStack - Lock-free MutantStack for sharing between threads
+ *
+ * A Treiber stack: push and pop are a single compare-and-swap on the head,
+ * so threads never block each other.
+ *
+ * - ABA: nodes come from a pool owned by the stack and are addressed by a
+ *   32-bit index. The head packs that index with a 32-bit tag that changes
+ *   on every successful update, so a head that was popped and re-pushed in
+ *   between no longer compares equal.
+ * - Memory: pool memory is never returned while the stack lives, so a
+ *   thread holding a stale head can always read its node's next link.
+ * - Iteration: snapshot() pins the stack, loads the head once and copies
+ *   the chain below it. Links never change once a node is pushed, so the
+ *   copy is the exact contents at that instant, even while other threads
+ *   push and pop. While any snapshot is being taken, popped nodes are
+ *   retired instead of reused; the last pin to leave recycles them.
+ *
+ * T must be copy constructible: a pop that races with a snapshot copies
+ * the value out and leaves the original for the snapshot to read.
+ */
+template<typename T>
+class ConcurrentMutantStack {
+private:
+    static constexpr std::uint32_t NIL = 0;                 // Index 0 means "no node"
+    static constexpr std::size_t FIRST_SEGMENT = 64;        // Nodes in segment 0; each next one doubles
+    static constexpr std::size_t SEGMENTS = 27;             // 64 * (2^27 - 1) covers every 32-bit index
+    static_assert(FIRST_SEGMENT * ((static_cast<std::size_t>(1) << SEGMENTS) - 1) >= 0xFFFFFFFEu,
+                  "segments must hold every node index allocateNode hands out");
+
+    struct Node {
+        std::atomic<std::uint32_t> next;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    // Tagged head: high 32 bits tag, low 32 bits node index (NIL = empty)
+    static std::uint64_t pack(std::uint32_t index, std::uint32_t tag) {
+        return (static_cast<std::uint64_t>(tag) << 32) | index;
+    }
+
+    static std::uint32_t indexOf(std::uint64_t head) {
+        return static_cast<std::uint32_t>(head);
+    }
+
+    static std::uint32_t tagOf(std::uint64_t head) {
+        return static_cast<std::uint32_t>(head >> 32);
+    }
+
+    std::atomic<std::uint64_t> _head;       // The stack itself
+    std::atomic<std::uint64_t> _free;       // Nodes ready for reuse
+    std::atomic<std::uint64_t> _retired;    // Popped while a snapshot was running
+    std::atomic<std::size_t> _pins;         // Snapshots in progress
+    std::atomic<std::size_t> _size;
+    std::atomic<std::uint32_t> _fresh;      // Next never-used node index
+    std::atomic<Node*> _segments[SEGMENTS];
+
+    // Atomics are neither copyable nor movable
+    ConcurrentMutantStack(const ConcurrentMutantStack& other);
+    ConcurrentMutantStack& operator=(const ConcurrentMutantStack& other);
+
+    Node& node(std::uint32_t index) {
+        std::size_t slot = index - 1;
+        std::size_t segment = static_cast<std::size_t>(std::bit_width(slot / FIRST_SEGMENT + 1)) - 1;
+        std::size_t offset = slot - FIRST_SEGMENT * ((static_cast<std::size_t>(1) << segment) - 1);
+        return _segments[segment].load(std::memory_order_acquire)[offset];
+    }
+
+    // Push a node onto one of the internal lists
+    void link(std::atomic<std::uint64_t>& list, std::uint32_t index) {
+        Node& n = node(index);
+        std::uint64_t head = list.load(std::memory_order_relaxed);
+        do {
+            n.next.store(indexOf(head), std::memory_order_relaxed);
+        } while (!list.compare_exchange_weak(head, pack(index, tagOf(head) + 1),
+                                             std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Pop a node from one of the internal lists, NIL if it is empty
+    std::uint32_t unlink(std::atomic<std::uint64_t>& list) {
+        std::uint64_t head = list.load(std::memory_order_acquire);
+        while (indexOf(head) != NIL) {
+            std::uint32_t next = node(indexOf(head)).next.load(std::memory_order_relaxed);
+            if (list.compare_exchange_weak(head, pack(next, tagOf(head) + 1),
+                                           std::memory_order_acquire, std::memory_order_acquire)) {
+                return indexOf(head);
+            }
+        }
+        return NIL;
+    }
+
+    // A node from the free list, or a never-used one
+    std::uint32_t allocateNode() {
+        std::uint32_t index = unlink(_free);
+        if (index != NIL) {
+            return index;
+        }
+        std::uint32_t fresh = _fresh.fetch_add(1, std::memory_order_relaxed);
+        if (fresh == 0xFFFFFFFFu) {
+            throw std::length_error("ConcurrentMutantStack node pool exhausted");
+        }
+        std::size_t slot = fresh - 1;
+        std::size_t segment = static_cast<std::size_t>(std::bit_width(slot / FIRST_SEGMENT + 1)) - 1;
+        if (_segments[segment].load(std::memory_order_acquire) == NULL) {
+            Node* nodes = new Node[FIRST_SEGMENT << segment];
+            Node* expected = NULL;
+            if (!_segments[segment].compare_exchange_strong(expected, nodes, std::memory_order_acq_rel)) {
+                delete[] nodes;
+            }
+        }
+        return fresh;
+    }
+
+    // Recycle the retired nodes if no snapshot can still be reading them
+    void drainRetired() {
+        std::uint64_t retired = _retired.exchange(pack(NIL, 0), std::memory_order_seq_cst);
+        std::uint32_t index = indexOf(retired);
+        // Every node on the list was unlinked before this point, so a
+        // snapshot starting from here on cannot reach it
+        bool safe = _pins.load(std::memory_order_seq_cst) == 0;
+        while (index != NIL) {
+            std::uint32_t next = node(index).next.load(std::memory_order_relaxed);
+            if (safe) {
+                node(index).value()->~T();
+                link(_free, index);
+            } else {
+                link(_retired, index);
+            }
+            index = next;
+        }
+    }
+
+    template<typename... Args>
+    void emplaceNode(Args&&... args) {
+        std::uint32_t index = allocateNode();
+        Node& n = node(index);
+        try {
+            ::new (static_cast<void*>(n.storage)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            link(_free, index);
+            throw;
+        }
+        // Counted before it is visible, so a racing pop never takes the
+        // count below zero
+        _size.fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t head = _head.load(std::memory_order_relaxed);
+        do {
+            n.next.store(indexOf(head), std::memory_order_relaxed);
+        } while (!_head.compare_exchange_weak(head, pack(index, tagOf(head) + 1),
+                                              std::memory_order_seq_cst, std::memory_order_relaxed));
+    }
+
+public:
+    typedef T value_type;
+
+    /**
+     * Snapshot - The stack's contents at one instant, bottom to top
+     *
+     * Offers the same iteration surface as MutantStack (begin() is the
+     * bottom, rbegin() the top). It owns copies of the values and is
+     * unaffected by later pushes and pops.
+     */
+    class Snapshot {
+    private:
+        std::vector<T> _values;
+
+        friend class ConcurrentMutantStack;
+
+    public:
+        typedef typename std::vector<T>::const_iterator iterator;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+        typedef typename std::vector<T>::const_reverse_iterator reverse_iterator;
+        typedef typename std::vector<T>::const_reverse_iterator const_reverse_iterator;
+
+        const_iterator begin() const { return _values.begin(); }
+        const_iterator end() const { return _values.end(); }
+        const_iterator cbegin() const { return _values.cbegin(); }
+        const_iterator cend() const { return _values.cend(); }
+        const_reverse_iterator rbegin() const { return _values.rbegin(); }
+        const_reverse_iterator rend() const { return _values.rend(); }
+        const_reverse_iterator crbegin() const { return _values.crbegin(); }
+        const_reverse_iterator crend() const { return _values.crend(); }
+
+        std::size_t size() const { return _values.size(); }
+        bool empty() const { return _values.empty(); }
+
+        // Top of the stack when the snapshot was taken
+        const T& top() const { return _values.back(); }
+    };
+
+    // Constructor
+    ConcurrentMutantStack()
+        : _head(pack(NIL, 0)), _free(pack(NIL, 0)), _retired(pack(NIL, 0)), _pins(0), _size(0), _fresh(1) {
+        for (std::size_t i = 0; i < SEGMENTS; ++i) {
+            _segments[i].store(NULL, std::memory_order_relaxed);
+        }
+    }
+
+    // Destructor (no other thread may be using the stack)
+    ~ConcurrentMutantStack() {
+        for (std::uint32_t index = indexOf(_head.load()); index != NIL; index = node(index).next.load()) {
+            node(index).value()->~T();
+        }
+        for (std::uint32_t index = indexOf(_retired.load()); index != NIL; index = node(index).next.load()) {
+            node(index).value()->~T();
+        }
+        for (std::size_t i = 0; i < SEGMENTS; ++i) {
+            delete[] _segments[i].load();
+        }
+    }
+
+    void push(const T& value) {
+        emplaceNode(value);
+    }
+
+    void push(T&& value) {
+        emplaceNode(std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        emplaceNode(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Pop the top element
+     * @param out Receives the popped value
+     * @return false if the stack was empty
+     */
+    bool tryPop(T& out) {
+        std::uint64_t head = _head.load(std::memory_order_seq_cst);
+        for (;;) {
+            std::uint32_t index = indexOf(head);
+            if (index == NIL) {
+                return false;
+            }
+            std::uint32_t next = node(index).next.load(std::memory_order_relaxed);
+            if (_head.compare_exchange_weak(head, pack(next, tagOf(head) + 1),
+                                            std::memory_order_seq_cst, std::memory_order_seq_cst)) {
+                break;
+            }
+        }
+        _size.fetch_sub(1, std::memory_order_relaxed);
+
+        Node& n = node(indexOf(head));
+        if (_pins.load(std::memory_order_seq_cst) == 0) {
+            // No snapshot started before the unlink, and none started after
+            // it can reach the node: it is ours alone
+            out = std::move(*n.value());
+            n.value()->~T();
+            link(_free, indexOf(head));
+        } else {
+            // A snapshot may be reading the value; leave it intact
+            out = *n.value();
+            link(_retired, indexOf(head));
+            if (_pins.load(std::memory_order_seq_cst) == 0) {
+                drainRetired();
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The whole stack at one instant
+     * @return Copies of the elements, bottom to top
+     */
+    Snapshot snapshot() {
+        Snapshot result;
+        result._values.reserve(_size.load(std::memory_order_relaxed));
+        _pins.fetch_add(1, std::memory_order_seq_cst);
+        try {
+            for (std::uint32_t index = indexOf(_head.load(std::memory_order_seq_cst)); index != NIL;
+                 index = node(index).next.load(std::memory_order_relaxed)) {
+                result._values.push_back(*node(index).value());
+            }
+        } catch (...) {
+            if (_pins.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+                drainRetired();
+            }
+            throw;
+        }
+        if (_pins.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            drainRetired();
+        }
+        std::reverse(result._values.begin(), result._values.end());
+        return result;
+    }
+
+    // Element count; exact only when no other thread is pushing or popping,
+    // otherwise it may include pushes still in flight
+    std::size_t size() const {
+        return _size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return indexOf(_head.load(std::memory_order_acquire)) == NIL;
+    }
+};
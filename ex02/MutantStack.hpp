@@ -2,6 +2,14 @@
 #include <stack>
 #include <iterator>
 #include <deque>
+#include <ranges>
+#include <stdexcept>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "SmallVector.hpp"
+#include "Segments.hpp"
+#include "instrument.hpp"
 
 /**
  * MutantStack - An iterable version of std::stack
@@ -10,10 +18,16 @@
  * by providing access to the underlying container's iterators.
  * 
  * The key insight is that std::stack is a container adapter with a 
- * protected member 'c' that holds the underlying container (default: std::deque).
+ * protected member 'c' that holds the underlying container.
  * By inheriting from std::stack, we can access this protected member.
+ *
+ * The default container is SmallVector<T>: contiguous storage with pointer
+ * iterators and an inline buffer, so shallow stacks never allocate. Any
+ * std::stack-compatible container (std::deque, std::vector, std::list)
+ * can still be chosen explicitly. A MutantStack converts to a std::stack
+ * over any other container, e.g. std::stack<int> s(mstack).
  */
-template<typename T, typename Container = std::deque<T>>
+template<typename T, typename Container = SmallVector<T>>
 class MutantStack : public std::stack<T, Container> {
 public:
     // Iterator typedefs - using the underlying container's iterators
@@ -22,12 +36,40 @@ public:
     typedef typename Container::reverse_iterator reverse_iterator;
     typedef typename Container::const_reverse_iterator const_reverse_iterator;
     
+    typedef typename std::stack<T, Container>::size_type size_type;
+    
     // Default constructor
     MutantStack() : std::stack<T, Container>() {}
     
+    // Range constructor: [first, last) bottom to top
+    template<typename Iterator>
+        requires std::input_iterator<Iterator>
+    MutantStack(Iterator first, Iterator last) : std::stack<T, Container>() {
+        push_range(first, last);
+    }
+    
     // Copy constructor
     MutantStack(const MutantStack& other) : std::stack<T, Container>(other) {}
     
+    // Allocator-extended constructors: the allocator is passed through to
+    // the underlying container (e.g. a StackArena's allocator())
+    template<typename Alloc>
+        requires std::uses_allocator_v<Container, Alloc>
+    explicit MutantStack(const Alloc& allocator) : std::stack<T, Container>(allocator) {}
+    
+    template<typename Alloc>
+        requires std::uses_allocator_v<Container, Alloc>
+    MutantStack(const MutantStack& other, const Alloc& allocator) : std::stack<T, Container>(other, allocator) {}
+    
+    template<typename Alloc>
+        requires std::uses_allocator_v<Container, Alloc>
+    MutantStack(MutantStack&& other, const Alloc& allocator)
+        : std::stack<T, Container>(std::move(other), allocator) {}
+    
+    // Move constructor
+    MutantStack(MutantStack&& other) noexcept(std::is_nothrow_move_constructible_v<Container>)
+        : std::stack<T, Container>(std::move(other)) {}
+    
     // Assignment operator
     MutantStack& operator=(const MutantStack& other) {
         if (this != &other) {
@@ -36,15 +78,135 @@ public:
         return *this;
     }
     
+    // Move assignment operator
+    MutantStack& operator=(MutantStack&& other) noexcept(std::is_nothrow_move_assignable_v<Container>) {
+        if (this != &other) {
+            std::stack<T, Container>::operator=(std::move(other));
+        }
+        return *this;
+    }
+    
     // Destructor
     ~MutantStack() {}
     
+    // Conversion to a std::stack over a different container (a std::stack
+    // over the same container is a base class and needs no conversion)
+    template<typename OtherContainer>
+        requires (!std::is_same_v<OtherContainer, Container>)
+    operator std::stack<T, OtherContainer>() const {
+        return std::stack<T, OtherContainer>(OtherContainer(this->c.begin(), this->c.end()));
+    }
+    
+#ifdef CPP08_INSTRUMENT
+    // Timed push/emplace/pop (see instrument.hpp); without
+    // CPP08_INSTRUMENT the std::stack members are used directly
+    void push(const T& value) {
+        CPP08_TIME(STACK_PUSH);
+        std::stack<T, Container>::push(value);
+    }
+    
+    void push(T&& value) {
+        CPP08_TIME(STACK_PUSH);
+        std::stack<T, Container>::push(std::move(value));
+    }
+    
+    template<typename... Args>
+    decltype(auto) emplace(Args&&... args) {
+        CPP08_TIME(STACK_PUSH);
+        return std::stack<T, Container>::emplace(std::forward<Args>(args)...);
+    }
+    
+    void pop() {
+        CPP08_TIME(STACK_POP);
+        std::stack<T, Container>::pop();
+    }
+#endif
+    
+    /**
+     * Push every element of [first, last), first element deepest
+     * @param first, last The elements to push
+     *
+     * One insert at the top of the container: with SmallVector (or
+     * std::vector) a forward range grows the storage at most once and
+     * contiguous trivially copyable input is block-copied.
+     */
+    template<typename Iterator>
+        requires std::input_iterator<Iterator>
+    void push_range(Iterator first, Iterator last) {
+        this->c.insert(this->c.end(), first, last);
+    }
+    
+    template<typename Range>
+        requires std::ranges::input_range<Range>
+    void push_range(Range&& range) {
+        push_range(std::ranges::begin(range), std::ranges::end(range));
+    }
+    
+    /**
+     * Discard the top n elements
+     * @param n How many elements to pop
+     * @throws std::out_of_range if the stack holds fewer than n elements
+     */
+    void pop_n(size_type n) {
+        if (n > this->c.size()) {
+            throw std::out_of_range("pop_n past the bottom of the stack");
+        }
+        this->c.erase(std::prev(this->c.end(), static_cast<std::ptrdiff_t>(n)), this->c.end());
+    }
+    
+    /**
+     * Pop the top n elements as one block
+     * @param n How many elements to pop
+     * @param out Receives the block, moved out in stack order (deepest
+     *            first, the old top last)
+     * @return out past the last element written
+     * @throws std::out_of_range if the stack holds fewer than n elements
+     */
+    template<typename OutputIterator>
+    OutputIterator pop_n(size_type n, OutputIterator out) {
+        if (n > this->c.size()) {
+            throw std::out_of_range("pop_n past the bottom of the stack");
+        }
+        iterator first = std::prev(this->c.end(), static_cast<std::ptrdiff_t>(n));
+        out = std::move(first, this->c.end(), out);
+        this->c.erase(first, this->c.end());
+        return out;
+    }
+    
+    // Size the storage up front so a run of push/emplace calls grows it at
+    // most once (containers with reserve(), e.g. SmallVector and std::vector)
+    void reserve(size_type n) requires requires(Container& c) { c.reserve(n); } {
+        this->c.reserve(n);
+    }
+    
+    /**
+     * Visit the elements bottom to top as contiguous (pointer, length)
+     * spans: one for SmallVector and std::vector, one per chunk for
+     * std::deque (see Segments.hpp)
+     * @param visitor Called as visitor(pointer, length); may return false
+     *                to stop
+     * @return false if the visitor stopped early
+     */
+    template<typename Visitor>
+    bool for_each_segment(Visitor&& visitor) {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
+        return forEachSegment(this->c.begin(), this->c.end(), std::forward<Visitor>(visitor));
+    }
+    
+    template<typename Visitor>
+    bool for_each_segment(Visitor&& visitor) const {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
+        return forEachSegment(this->c.begin(), this->c.end(), std::forward<Visitor>(visitor));
+    }
+    
     // Iterator methods - forward iterators
     iterator begin() {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.begin();
     }
     
     const_iterator begin() const {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.begin();
     }
     
@@ -58,10 +220,12 @@ public:
     
     // Reverse iterator methods
     reverse_iterator rbegin() {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.rbegin();
     }
     
     const_reverse_iterator rbegin() const {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.rbegin();
     }
     
@@ -75,6 +239,7 @@ public:
     
     // Const iterator methods (C++11 style)
     const_iterator cbegin() const {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.cbegin();
     }
     
@@ -83,6 +248,7 @@ public:
     }
     
     const_reverse_iterator crbegin() const {
+        CPP08_RECORD(STACK_ITERATE, this->c.size());
         return this->c.crbegin();
     }
     
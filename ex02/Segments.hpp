@@ -0,0 +1,201 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Segments - Iterate a container as runs of contiguous elements
+ *
+ * A std::deque stores its elements in fixed-size chunks, so every ++ on a
+ * deque iterator checks for the end of a chunk and loops over it do not
+ * vectorize. forEachSegment() instead hands the visitor one
+ * (pointer, length) span per chunk, and the visitor runs a plain pointer
+ * loop over each one:
+ *
+ *     forEachSegment(d.begin(), d.end(), [&](const int* p, std::size_t n) {
+ *         for (std::size_t i = 0; i < n; ++i) sum += p[i];
+ *     });
+ *
+ * - Contiguous iterators (SmallVector, std::vector): one segment.
+ * - Other random-access iterators (std::deque): one segment per chunk.
+ *   The end of each chunk is found through the standard interface by
+ *   galloping and then bisecting on &*(first + k) == &*first + k, so it
+ *   costs O(log chunk) per segment instead of a check per element. This
+ *   assumes the storage is made of contiguous blocks that are no shorter
+ *   than the block before them, as every library's deque is: a probe
+ *   then always lands in the block right after a run, never beyond it.
+ * - Anything else (std::list): runs of elements found to be adjacent in
+ *   memory, walking the iterators one by one.
+ *
+ * The visitor may return bool: false stops the walk after that segment.
+ */
+namespace segments_detail {
+
+// Call the visitor; false if it asked to stop
+template<typename Visitor, typename Pointer>
+bool visit(Visitor& visitor, Pointer data, std::size_t length) {
+    if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, Pointer, std::size_t>, bool>) {
+        return visitor(data, length);
+    } else {
+        visitor(data, length);
+        return true;
+    }
+}
+
+} // namespace segments_detail
+
+/**
+ * Visit [first, last) as contiguous spans, in iteration order
+ * @param first, last The elements to visit
+ * @param visitor Called as visitor(pointer, length) for each non-empty span
+ * @return false if the visitor stopped the walk early
+ */
+template<typename Iterator, typename Visitor>
+    requires std::forward_iterator<Iterator> && std::is_lvalue_reference_v<std::iter_reference_t<Iterator>>
+bool forEachSegment(Iterator first, Iterator last, Visitor&& visitor) {
+    typedef std::remove_reference_t<std::iter_reference_t<Iterator>>* Pointer;
+
+    if constexpr (std::contiguous_iterator<Iterator>) {
+        if (first == last) {
+            return true;
+        }
+        return segments_detail::visit(visitor, std::to_address(first), static_cast<std::size_t>(last - first));
+    } else if constexpr (std::random_access_iterator<Iterator>) {
+        // Length of the last run that was neither first nor last: a whole
+        // block, and the likely length of the next one
+        std::size_t block = 0;
+        bool first_run = true;
+        while (first != last) {
+            Pointer start = std::addressof(*first);
+            std::size_t remaining = static_cast<std::size_t>(last - first);
+            // Runs of length `known` are contiguous; `beyond` is not (or
+            // runs off the range)
+            std::size_t known = 1;
+            std::size_t beyond = remaining + 1;
+            // One probe confirms a run of one more whole block. The run is
+            // not extended past it: a segment only has to be contiguous,
+            // and blocks that happen to sit back to back are simply
+            // visited as two segments...
+            if (block > 1 && block <= remaining
+                && std::addressof(first[static_cast<std::ptrdiff_t>(block - 1)]) == start + (block - 1)) {
+                known = block;
+                beyond = block + 1;
+            }
+            // ...otherwise gallop to bracket the run's end...
+            while (beyond == remaining + 1 && known < remaining) {
+                std::size_t probe = known * 2 < remaining ? known * 2 : remaining;
+                if (std::addressof(first[static_cast<std::ptrdiff_t>(probe - 1)]) != start + (probe - 1)) {
+                    beyond = probe;
+                    break;
+                }
+                known = probe;
+            }
+            // ...then bisect between the two
+            while (beyond - known > 1) {
+                std::size_t middle = known + (beyond - known) / 2;
+                if (std::addressof(first[static_cast<std::ptrdiff_t>(middle - 1)]) == start + (middle - 1)) {
+                    known = middle;
+                } else {
+                    beyond = middle;
+                }
+            }
+            if (!segments_detail::visit(visitor, start, known)) {
+                return false;
+            }
+            first += static_cast<std::ptrdiff_t>(known);
+            if (!first_run) {
+                block = known;
+            }
+            first_run = false;
+        }
+        return true;
+    } else {
+        while (first != last) {
+            Pointer start = std::addressof(*first);
+            std::size_t length = 1;
+            for (++first; first != last && std::addressof(*first) == start + length; ++first) {
+                ++length;
+            }
+            if (!segments_detail::visit(visitor, start, length)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * std::for_each over a MutantStack (or any container with
+ * for_each_segment()), bottom to top, one tight loop per segment
+ * @param stack The elements to visit
+ * @param function Called with each element
+ * @return function, like std::for_each
+ */
+template<typename Stack, typename Function>
+Function segmented_for_each(Stack& stack, Function function) {
+    stack.for_each_segment([&function](auto* data, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            function(data[i]);
+        }
+    });
+    return function;
+}
+
+/**
+ * std::accumulate over a MutantStack, bottom to top, one segment at a time
+ * @param stack The elements to fold
+ * @param init The initial value
+ * @param op The fold, init = op(init, element)
+ * @return The folded value
+ */
+template<typename Stack, typename Value, typename BinaryOperation = std::plus<>>
+Value segmented_accumulate(const Stack& stack, Value init, BinaryOperation op = BinaryOperation()) {
+    stack.for_each_segment([&init, &op](auto* data, std::size_t length) {
+        init = std::accumulate(data, data + length, std::move(init), op);
+    });
+    return init;
+}
+
+/**
+ * First occurrence of value in a MutantStack, bottom to top, searching
+ * each segment with std::find over pointers (an easyfind for stacks)
+ * @param stack The stack to search
+ * @param value The value to find
+ * @return Iterator to the first occurrence of the value, or stack.end()
+ */
+template<typename Stack, typename V>
+auto segmented_find(Stack& stack, const V& value, const std::nothrow_t&) -> decltype(stack.begin()) {
+    std::size_t offset = 0;
+    bool found = !stack.for_each_segment([&offset, &value](auto* data, std::size_t length) {
+        auto* hit = std::find(data, data + length, value);
+        offset += static_cast<std::size_t>(hit - data);
+        return hit == data + length;
+    });
+    if (!found) {
+        return stack.end();
+    }
+    return std::next(stack.begin(), static_cast<std::ptrdiff_t>(offset));
+}
+
+/**
+ * First occurrence of value in a MutantStack, like easyfind
+ * @param stack The stack to search
+ * @param value The value to find
+ * @return Iterator to the first occurrence of the value
+ * @throws std::runtime_error if the value is not found
+ */
+template<typename Stack, typename V>
+auto segmented_find(Stack& stack, const V& value) -> decltype(stack.begin()) {
+    auto it = segmented_find(stack, value, std::nothrow);
+    if (it == stack.end()) {
+        throw std::runtime_error("Value not found in stack");
+    }
+    return it;
+}
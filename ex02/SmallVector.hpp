@@ -0,0 +1,504 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace smallvector_detail {
+
+template<typename T>
+inline constexpr std::size_t defaultInline = sizeof(T) <= 64 ? 64 / sizeof(T) : 0;
+
+} // namespace smallvector_detail
+
+/**
+ * SmallVector - Contiguous stack storage with an inline buffer
+ *
+ * A vector-like sequence that satisfies everything std::stack needs from
+ * its container (back, push_back, emplace_back, pop_back, size, empty) and
+ * is MutantStack's default container.
+ *
+ * - The first N elements live inside the object itself, so a stack that
+ *   never grows past N never touches the heap
+ * - Past N, storage moves to the allocator and grows geometrically (x2),
+ *   so pushes are amortized O(1)
+ * - Elements are contiguous and the iterators are plain pointers, so loops
+ *   over a MutantStack compile like loops over an array
+ * - Moving a heap-backed SmallVector steals the buffer; moving an inline
+ *   one moves its (at most N) elements
+ *
+ * N defaults to as many elements as fit in 64 bytes (16 ints), and to 0
+ * for element types larger than that.
+ */
+template<typename T, std::size_t N = smallvector_detail::defaultInline<T>,
+         typename Allocator = std::allocator<T>>
+class SmallVector {
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+private:
+    typedef std::allocator_traits<Allocator> Traits;
+
+    // Relocating by memcpy is only safe for trivially copyable types
+    static constexpr bool TRIVIAL = std::is_trivially_copyable_v<T>;
+
+    T* _data;
+    size_type _size;
+    size_type _capacity;
+    [[no_unique_address]] Allocator _allocator;
+    alignas(T) unsigned char _inline[N == 0 ? 1 : N * sizeof(T)];
+
+    T* inlineData() {
+        return reinterpret_cast<T*>(_inline);
+    }
+
+    bool onHeap() const {
+        return _capacity > N;
+    }
+
+    void destroyAll() {
+        for (size_type i = 0; i < _size; ++i) {
+            Traits::destroy(_allocator, _data + i);
+        }
+        _size = 0;
+    }
+
+    // Release heap storage (elements must already be destroyed)
+    void releaseStorage() {
+        if (onHeap()) {
+            Traits::deallocate(_allocator, _data, _capacity);
+        }
+        _data = inlineData();
+        _capacity = N;
+    }
+
+    // Move-construct count elements from `from` into uninitialized `to`,
+    // copying instead when T's move may throw and a copy is available
+    void relocate(T* from, size_type count, T* to) {
+        if constexpr (TRIVIAL) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+            }
+        } else {
+            size_type built = 0;
+            try {
+                for (; built < count; ++built) {
+                    Traits::construct(_allocator, to + built, std::move_if_noexcept(from[built]));
+                }
+            } catch (...) {
+                for (size_type i = 0; i < built; ++i) {
+                    Traits::destroy(_allocator, to + i);
+                }
+                throw;
+            }
+            for (size_type i = 0; i < count; ++i) {
+                Traits::destroy(_allocator, from + i);
+            }
+        }
+    }
+
+    size_type grownCapacity(size_type needed) const {
+        if (needed > max_size()) {
+            throw std::length_error("SmallVector capacity overflow");
+        }
+        size_type grown = _capacity < max_size() / 2 ? _capacity * 2 : max_size();
+        if (grown < 4) {
+            grown = 4;
+        }
+        return grown < needed ? needed : grown;
+    }
+
+    // Move the elements into a fresh heap block of exactly `capacity`
+    void reallocate(size_type capacity) {
+        T* fresh = Traits::allocate(_allocator, capacity);
+        try {
+            relocate(_data, _size, fresh);
+        } catch (...) {
+            Traits::deallocate(_allocator, fresh, capacity);
+            throw;
+        }
+        if (onHeap()) {
+            Traits::deallocate(_allocator, _data, _capacity);
+        }
+        _data = fresh;
+        _capacity = capacity;
+    }
+
+    // Growing push: the new element is built in the new block before the
+    // old elements move, so arguments referring into *this stay valid
+    template<typename... Args>
+    T& emplaceGrow(Args&&... args) {
+        size_type capacity = grownCapacity(_size + 1);
+        T* fresh = Traits::allocate(_allocator, capacity);
+        try {
+            Traits::construct(_allocator, fresh + _size, std::forward<Args>(args)...);
+        } catch (...) {
+            Traits::deallocate(_allocator, fresh, capacity);
+            throw;
+        }
+        try {
+            relocate(_data, _size, fresh);
+        } catch (...) {
+            Traits::destroy(_allocator, fresh + _size);
+            Traits::deallocate(_allocator, fresh, capacity);
+            throw;
+        }
+        if (onHeap()) {
+            Traits::deallocate(_allocator, _data, _capacity);
+        }
+        _data = fresh;
+        _capacity = capacity;
+        return _data[_size++];
+    }
+
+    template<typename Iterator>
+    void appendCopies(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    // Take other's contents; other's allocator is known to be usable here
+    void steal(SmallVector& other) {
+        if (other.onHeap()) {
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._data = other.inlineData();
+            other._size = 0;
+            other._capacity = N;
+        } else {
+            relocate(other._data, other._size, _data);
+            _size = other._size;
+            other._size = 0;
+        }
+    }
+
+public:
+    // Default constructor
+    SmallVector() noexcept(noexcept(Allocator()))
+        : _data(inlineData()), _size(0), _capacity(N), _allocator() {}
+
+    explicit SmallVector(const Allocator& allocator) noexcept
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(allocator) {}
+
+    SmallVector(size_type count, const T& value, const Allocator& allocator = Allocator())
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(allocator) {
+        reserve(count);
+        for (size_type i = 0; i < count; ++i) {
+            emplace_back(value);
+        }
+    }
+
+    template<typename Iterator>
+        requires std::input_iterator<Iterator>
+    SmallVector(Iterator first, Iterator last, const Allocator& allocator = Allocator())
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(allocator) {
+        if constexpr (std::forward_iterator<Iterator>) {
+            reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        insert(end(), first, last);
+    }
+
+    // Copy constructor
+    SmallVector(const SmallVector& other)
+        : _data(inlineData()), _size(0), _capacity(N),
+          _allocator(Traits::select_on_container_copy_construction(other._allocator)) {
+        reserve(other._size);
+        appendCopies(other.begin(), other.end());
+    }
+
+    SmallVector(const SmallVector& other, const Allocator& allocator)
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(allocator) {
+        reserve(other._size);
+        appendCopies(other.begin(), other.end());
+    }
+
+    // Move constructor
+    SmallVector(SmallVector&& other) noexcept(TRIVIAL || std::is_nothrow_move_constructible_v<T>)
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(std::move(other._allocator)) {
+        steal(other);
+    }
+
+    SmallVector(SmallVector&& other, const Allocator& allocator)
+        : _data(inlineData()), _size(0), _capacity(N), _allocator(allocator) {
+        if (Traits::is_always_equal::value || _allocator == other._allocator) {
+            steal(other);
+        } else {
+            reserve(other._size);
+            for (size_type i = 0; i < other._size; ++i) {
+                emplace_back(std::move(other._data[i]));
+            }
+            other.clear();
+        }
+    }
+
+    // Assignment operator
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+                if (_allocator != other._allocator) {
+                    destroyAll();
+                    releaseStorage();
+                }
+                _allocator = other._allocator;
+            }
+            clear();
+            reserve(other._size);
+            appendCopies(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    // Move assignment operator
+    SmallVector& operator=(SmallVector&& other) noexcept(
+        (Traits::propagate_on_container_move_assignment::value || Traits::is_always_equal::value)
+        && (TRIVIAL || std::is_nothrow_move_constructible_v<T>)) {
+        if (this != &other) {
+            destroyAll();
+            if (Traits::propagate_on_container_move_assignment::value || _allocator == other._allocator) {
+                releaseStorage();
+                if constexpr (Traits::propagate_on_container_move_assignment::value) {
+                    _allocator = std::move(other._allocator);
+                }
+                steal(other);
+            } else {
+                reserve(other._size);
+                for (size_type i = 0; i < other._size; ++i) {
+                    emplace_back(std::move(other._data[i]));
+                }
+                other.clear();
+            }
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~SmallVector() {
+        destroyAll();
+        releaseStorage();
+    }
+
+    allocator_type get_allocator() const {
+        return _allocator;
+    }
+
+    // Iterators
+    iterator begin() noexcept { return _data; }
+    const_iterator begin() const noexcept { return _data; }
+    iterator end() noexcept { return _data + _size; }
+    const_iterator end() const noexcept { return _data + _size; }
+    const_iterator cbegin() const noexcept { return _data; }
+    const_iterator cend() const noexcept { return _data + _size; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // Capacity
+    size_type size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    size_type capacity() const noexcept { return _capacity; }
+
+    size_type max_size() const noexcept {
+        size_type limit = Traits::max_size(_allocator);
+        size_type bytes = std::numeric_limits<difference_type>::max() / sizeof(T);
+        return limit < bytes ? limit : bytes;
+    }
+
+    // Whether the elements are still in the inline buffer
+    bool is_inline() const noexcept {
+        return !onHeap();
+    }
+
+    void reserve(size_type capacity) {
+        if (capacity > _capacity) {
+            if (capacity > max_size()) {
+                throw std::length_error("SmallVector capacity overflow");
+            }
+            reallocate(capacity);
+        }
+    }
+
+    // Element access
+    T* data() noexcept { return _data; }
+    const T* data() const noexcept { return _data; }
+    reference operator[](size_type index) { return _data[index]; }
+    const_reference operator[](size_type index) const { return _data[index]; }
+    reference front() { return _data[0]; }
+    const_reference front() const { return _data[0]; }
+    reference back() { return _data[_size - 1]; }
+    const_reference back() const { return _data[_size - 1]; }
+
+    reference at(size_type index) {
+        if (index >= _size) {
+            throw std::out_of_range("SmallVector index out of range");
+        }
+        return _data[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= _size) {
+            throw std::out_of_range("SmallVector index out of range");
+        }
+        return _data[index];
+    }
+
+    // Modifiers
+    template<typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (_size == _capacity) {
+            return emplaceGrow(std::forward<Args>(args)...);
+        }
+        Traits::construct(_allocator, _data + _size, std::forward<Args>(args)...);
+        return _data[_size++];
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        --_size;
+        Traits::destroy(_allocator, _data + _size);
+    }
+
+    /**
+     * Insert [first, last) before position
+     * @param position Where the new elements go (end() appends)
+     * @param first, last The elements to copy in; must not point into *this
+     * @return Iterator to the first inserted element
+     *
+     * A forward range is counted first, so the storage grows at most once;
+     * trivially copyable elements from contiguous input are block-copied.
+     */
+    template<typename Iterator>
+        requires std::input_iterator<Iterator>
+    iterator insert(const_iterator position, Iterator first, Iterator last) {
+        size_type index = static_cast<size_type>(position - _data);
+        size_type oldSize = _size;
+        if constexpr (std::forward_iterator<Iterator>) {
+            size_type count = static_cast<size_type>(std::distance(first, last));
+            if (count == 0) {
+                return _data + index;
+            }
+            if (_size + count > _capacity) {
+                reallocate(grownCapacity(_size + count));
+            }
+            if constexpr (TRIVIAL) {
+                T* gap = _data + index;
+                if (index != _size) {
+                    std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap),
+                                 (_size - index) * sizeof(T));
+                }
+                std::uninitialized_copy(first, last, gap);
+                _size += count;
+                return gap;
+            }
+        }
+        // Append, then rotate the new elements into place
+        try {
+            for (; first != last; ++first) {
+                emplace_back(*first);
+            }
+        } catch (...) {
+            while (_size > oldSize) {
+                pop_back();
+            }
+            throw;
+        }
+        std::rotate(_data + index, _data + oldSize, _data + _size);
+        return _data + index;
+    }
+
+    iterator insert(const_iterator position, const T& value) {
+        // Copied first: value may be an element that growth would move
+        T copy(value);
+        return insert(position, std::make_move_iterator(&copy), std::make_move_iterator(&copy + 1));
+    }
+
+    // Remove [first, last); later elements move down to close the gap
+    iterator erase(const_iterator first, const_iterator last) {
+        T* from = _data + (first - _data);
+        T* to = _data + (last - _data);
+        size_type count = static_cast<size_type>(to - from);
+        if (count != 0) {
+            std::move(to, _data + _size, from);
+            for (size_type i = _size - count; i < _size; ++i) {
+                Traits::destroy(_allocator, _data + i);
+            }
+            _size -= count;
+        }
+        return from;
+    }
+
+    iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+
+    // Destroys the elements but keeps the storage for reuse
+    void clear() noexcept {
+        destroyAll();
+    }
+
+    void swap(SmallVector& other) {
+        if (this == &other) {
+            return;
+        }
+        if (onHeap() && other.onHeap()) {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+        } else {
+            SmallVector held(std::move(other));
+            other = std::move(*this);
+            *this = std::move(held);
+            return;
+        }
+        if constexpr (Traits::propagate_on_container_swap::value) {
+            std::swap(_allocator, other._allocator);
+        }
+    }
+};
+
+template<typename T, std::size_t N, typename Allocator>
+bool operator==(const SmallVector<T, N, Allocator>& lhs, const SmallVector<T, N, Allocator>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, std::size_t N, typename Allocator>
+bool operator<(const SmallVector<T, N, Allocator>& lhs, const SmallVector<T, N, Allocator>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename T, std::size_t N, typename Allocator>
+void swap(SmallVector<T, N, Allocator>& lhs, SmallVector<T, N, Allocator>& rhs)
+{
+    lhs.swap(rhs);
+}
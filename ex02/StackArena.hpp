@@ -0,0 +1,186 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "SmallVector.hpp"
+#include "MutantStack.hpp"
+
+template<typename T> class ArenaAllocator;
+
+/**
+ * StackArena - Monotonic arena for many short-lived MutantStacks
+ *
+ * Allocation bumps a pointer through chunks obtained from operator new;
+ * deallocation is free (the most recent block is given back, anything
+ * else waits for reset()). reset() rewinds every chunk at once but keeps
+ * them, so after the first request has sized the arena, later requests
+ * allocate nothing from the system:
+ *
+ *     StackArena arena;
+ *     for (each request) {
+ *         ArenaMutantStack<int> stack(arena.allocator());
+ *         ...parse...
+ *         // stack destroyed here
+ *         arena.reset();
+ *     }
+ *
+ * Everything allocated from the arena must be destroyed before reset().
+ * The arena is not thread-safe; use one per thread.
+ */
+class StackArena {
+private:
+    struct Chunk {
+        unsigned char* data;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> _chunks;
+    std::size_t _current;       // Chunk being bumped through
+    std::size_t _offset;        // Bytes used in the current chunk
+    std::size_t _chunkSize;     // Size of the next chunk to obtain
+    std::size_t _systemAllocations;
+
+    // Find room in a later chunk or obtain a new one
+    void* allocateSlow(std::size_t bytes, std::size_t alignment) {
+        while (_current + 1 < _chunks.size()) {
+            ++_current;
+            _offset = 0;
+            if (bytes + alignment <= _chunks[_current].size) {
+                return allocate(bytes, alignment);
+            }
+        }
+        std::size_t size = _chunkSize;
+        while (size < bytes + alignment) {
+            size *= 2;
+        }
+        Chunk chunk = {static_cast<unsigned char*>(::operator new(size)), size};
+        _chunks.push_back(chunk);
+        ++_systemAllocations;
+        _chunkSize = size * 2;
+        _current = _chunks.size() - 1;
+        _offset = 0;
+        return allocate(bytes, alignment);
+    }
+
+    // Arenas hand out pointers into themselves and cannot be copied
+    StackArena(const StackArena& other);
+    StackArena& operator=(const StackArena& other);
+
+public:
+    // Constructor
+    explicit StackArena(std::size_t chunkSize = 64 * 1024)
+        : _current(0), _offset(0), _chunkSize(chunkSize < 64 ? 64 : chunkSize), _systemAllocations(0) {}
+
+    // Destructor
+    ~StackArena() {
+        for (std::size_t i = 0; i < _chunks.size(); ++i) {
+            ::operator delete(_chunks[i].data);
+        }
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        if (!_chunks.empty()) {
+            Chunk& chunk = _chunks[_current];
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data);
+            std::size_t start = ((base + _offset + alignment - 1) & ~(alignment - 1)) - base;
+            if (start + bytes <= chunk.size) {
+                _offset = start + bytes;
+                return chunk.data + start;
+            }
+        }
+        return allocateSlow(bytes, alignment);
+    }
+
+    // Only the most recent block is reclaimed; the rest waits for reset()
+    void deallocate(void* pointer, std::size_t bytes) {
+        if (!_chunks.empty() && static_cast<unsigned char*>(pointer) + bytes == _chunks[_current].data + _offset) {
+            _offset -= bytes;
+        }
+    }
+
+    // Rewind every chunk; all memory handed out becomes free again
+    void reset() {
+        _current = 0;
+        _offset = 0;
+    }
+
+    // Allocator over this arena, for any container's allocator-extended
+    // constructor: ArenaMutantStack<int> stack(arena.allocator())
+    ArenaAllocator<unsigned char> allocator();
+
+    // Chunks obtained from operator new since construction
+    std::size_t systemAllocations() const {
+        return _systemAllocations;
+    }
+
+    // Total bytes held, in use or not
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < _chunks.size(); ++i) {
+            total += _chunks[i].size;
+        }
+        return total;
+    }
+};
+
+/**
+ * ArenaAllocator - Standard allocator over a StackArena
+ *
+ * Copies share the arena; two allocators compare equal when they use the
+ * same arena, so containers in one arena move by stealing buffers.
+ */
+template<typename T>
+class ArenaAllocator {
+private:
+    StackArena* _arena;
+
+    template<typename U> friend class ArenaAllocator;
+
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    // Constructor
+    explicit ArenaAllocator(StackArena& arena) noexcept : _arena(&arena) {}
+
+    // Copy constructor (also from allocators of other element types)
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : _arena(other._arena) {}
+
+    T* allocate(std::size_t count) {
+        if (count > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        _arena->deallocate(pointer, count * sizeof(T));
+    }
+
+    StackArena& arena() const noexcept {
+        return *_arena;
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return _arena == other._arena;
+    }
+};
+
+inline ArenaAllocator<unsigned char> StackArena::allocator()
+{
+    return ArenaAllocator<unsigned char>(*this);
+}
+
+// Contiguous arena-backed stack storage (inline buffer first, then the arena)
+template<typename T, std::size_t N = smallvector_detail::defaultInline<T>>
+using ArenaSmallVector = SmallVector<T, N, ArenaAllocator<T>>;
+
+// MutantStack whose storage comes from a StackArena:
+// ArenaMutantStack<int> stack(arena.allocator());
+template<typename T, std::size_t N = smallvector_detail::defaultInline<T>>
+using ArenaMutantStack = MutantStack<T, ArenaSmallVector<T, N>>;
@@ -0,0 +1,294 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "WorkStealingDeque.hpp"
+
+/**
+ * TaskScheduler / TaskGroup - Small fork-join thread pool over
+ * WorkStealingDeque
+ *
+ * Each worker owns a WorkStealingDeque of tasks. Tasks spawned from a
+ * worker go on top of its own deque and are popped LIFO, so a worker keeps
+ * working depth-first on data that is still in its cache. An idle worker
+ * steals the oldest task from another worker's bottom. Tasks spawned from
+ * outside the pool go to a mutex-guarded injection queue, which workers
+ * only look at when they have nothing else to do.
+ *
+ *     TaskScheduler scheduler;            // One worker per core
+ *     TaskGroup group(scheduler);
+ *     group.run([&] { left = fib(n - 1); });
+ *     right = fib(n - 2);
+ *     group.wait();                       // Runs or steals tasks meanwhile
+ *
+ * wait() never blocks while there is work anywhere in the pool: the
+ * waiting thread runs tasks itself until its group is done, so nested
+ * groups cannot deadlock even with a single worker.
+ */
+class TaskGroup;
+
+class TaskScheduler {
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        void (*invoke)(Task*);
+        TaskGroup* group;
+    };
+
+    template<typename Function>
+    struct FunctionTask : Task {
+        Function function;
+
+        FunctionTask(Function&& f, TaskGroup* owner) : function(std::move(f)) {
+            this->invoke = &FunctionTask::run;
+            this->group = owner;
+        }
+
+        // Frees the task before running it, so an exception leaks nothing
+        static void run(Task* task) {
+            FunctionTask* self = static_cast<FunctionTask*>(task);
+            Function function(std::move(self->function));
+            delete self;
+            function();
+        }
+    };
+
+    struct Worker {
+        WorkStealingDeque<Task*> tasks;
+        std::thread thread;
+        unsigned int seed;
+    };
+
+    std::vector<Worker*> _workers;
+    std::mutex _injectMutex;
+    std::deque<Task*> _injected;
+    std::atomic<std::size_t> _injectedCount;
+
+    // Idle workers sleep here; spawners notify only if someone sleeps
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    std::atomic<unsigned int> _sleepers;
+    std::atomic<bool> _stopping;
+
+    // Worker index of the calling thread in this scheduler, or -1
+    static int& currentIndex() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    static TaskScheduler*& currentScheduler() {
+        static thread_local TaskScheduler* scheduler = NULL;
+        return scheduler;
+    }
+
+    int workerIndex() {
+        return currentScheduler() == this ? currentIndex() : -1;
+    }
+
+    // Schedulers own threads and cannot be copied
+    TaskScheduler(const TaskScheduler& other);
+    TaskScheduler& operator=(const TaskScheduler& other);
+
+    void submit(Task* task) {
+        int index = workerIndex();
+        if (index >= 0) {
+            _workers[index]->tasks.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock(_injectMutex);
+            _injected.push_back(task);
+            _injectedCount.fetch_add(1, std::memory_order_seq_cst);
+        }
+        if (_sleepers.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _wake.notify_one();
+        }
+    }
+
+    // One task from anywhere in the pool, own deque first
+    Task* findTask(int self) {
+        Task* task = NULL;
+        if (self >= 0 && _workers[self]->tasks.pop(task)) {
+            return task;
+        }
+        std::size_t count = _workers.size();
+        if (count != 0) {
+            unsigned int start = self >= 0 ? nextRandom(_workers[self]->seed) : 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                std::size_t victim = (start + i) % count;
+                if (static_cast<int>(victim) != self && _workers[victim]->tasks.steal(task)) {
+                    return task;
+                }
+            }
+        }
+        if (_injectedCount.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(_injectMutex);
+            if (!_injected.empty()) {
+                task = _injected.front();
+                _injected.pop_front();
+                _injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return NULL;
+    }
+
+    static unsigned int nextRandom(unsigned int& seed) {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    }
+
+    inline void execute(Task* task);
+
+    void workerLoop(int index) {
+        currentScheduler() = this;
+        currentIndex() = index;
+        unsigned int idle = 0;
+        while (!_stopping.load(std::memory_order_acquire)) {
+            Task* task = findTask(index);
+            if (task != NULL) {
+                execute(task);
+                idle = 0;
+                continue;
+            }
+            if (++idle < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Nothing found for a while: sleep until a spawn (or a timeout,
+            // which covers a spawn racing with falling asleep)
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleepers.fetch_add(1, std::memory_order_seq_cst);
+            _wake.wait_for(lock, std::chrono::milliseconds(1));
+            _sleepers.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+        currentScheduler() = NULL;
+        currentIndex() = -1;
+    }
+
+public:
+    // Constructor: threads == 0 means one worker per hardware thread
+    explicit TaskScheduler(unsigned int threads = 0)
+        : _injectedCount(0), _sleepers(0), _stopping(false) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        if (threads == 0) {
+            threads = 1;
+        }
+        for (unsigned int i = 0; i < threads; ++i) {
+            _workers.push_back(new Worker());
+            _workers.back()->seed = 0x9E3779B9u * (i + 1);
+        }
+        for (unsigned int i = 0; i < threads; ++i) {
+            _workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, static_cast<int>(i));
+        }
+    }
+
+    // Destructor: every TaskGroup must have been waited on
+    ~TaskScheduler() {
+        _stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _wake.notify_all();
+        }
+        // Join everyone before freeing any deque a thief might still read
+        for (std::size_t i = 0; i < _workers.size(); ++i) {
+            _workers[i]->thread.join();
+        }
+        for (std::size_t i = 0; i < _workers.size(); ++i) {
+            delete _workers[i];
+        }
+    }
+
+    unsigned int threads() const {
+        return static_cast<unsigned int>(_workers.size());
+    }
+};
+
+/**
+ * TaskGroup - A set of tasks to wait for together
+ *
+ * run() spawns a task; wait() returns once every task spawned through this
+ * group has finished, and rethrows the first exception any of them threw.
+ * Tasks may create and wait on their own groups.
+ */
+class TaskGroup {
+private:
+    friend class TaskScheduler;
+
+    TaskScheduler& _scheduler;
+    std::atomic<std::size_t> _pending;
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+
+    // Groups are tied to their tasks and cannot be copied
+    TaskGroup(const TaskGroup& other);
+    TaskGroup& operator=(const TaskGroup& other);
+
+    void fail(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error) {
+            _error = error;
+        }
+    }
+
+public:
+    // Constructor
+    explicit TaskGroup(TaskScheduler& scheduler) : _scheduler(scheduler), _pending(0) {}
+
+    // Destructor: waits for outstanding tasks, discarding their exceptions
+    ~TaskGroup() {
+        try {
+            wait();
+        } catch (...) {
+        }
+    }
+
+    template<typename Function>
+    void run(Function&& function) {
+        typedef TaskScheduler::FunctionTask<std::decay_t<Function>> Spawned;
+        Spawned* task = new Spawned(std::decay_t<Function>(std::forward<Function>(function)), this);
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        _scheduler.submit(task);
+    }
+
+    // Help run tasks until this group's tasks are all done
+    void wait() {
+        int self = _scheduler.workerIndex();
+        while (_pending.load(std::memory_order_acquire) != 0) {
+            TaskScheduler::Task* task = _scheduler.findTask(self);
+            if (task != NULL) {
+                _scheduler.execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (_error) {
+            std::exception_ptr error = _error;
+            _error = NULL;
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+inline void TaskScheduler::execute(Task* task)
+{
+    TaskGroup* group = task->group;
+    try {
+        task->invoke(task);
+    } catch (...) {
+        group->fail(std::current_exception());
+    }
+    group->_pending.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * WorkStealingDeque - Chase-Lev deque for per-worker task stacks
+ *
+ * The owning thread uses it like a MutantStack: push() and pop() work on
+ * the top, LIFO, without contention (one full barrier and, only when a single
+ * element is left, one CAS). Any other thread may steal() from the bottom,
+ * FIFO, so thieves take the oldest (usually largest) pieces of work and
+ * stay away from the owner's end.
+ *
+ * This is the C11 formulation of Le, Pop, Cohen and Zappa Nardelli (2013),
+ * with their "bottom" (owner end) called top here and their "top" (thief
+ * end) called bottom, to match the stack view. Their seq_cst fences are
+ * expressed as seq_cst loads and stores, which cost the same on x86 and
+ * which ThreadSanitizer can follow.
+ *
+ * The ring buffer doubles when full. Old buffers are kept until the deque
+ * is destroyed, because a thief may still be reading one.
+ *
+ * T must be trivially copyable (typically a pointer to a task).
+ */
+template<typename T>
+class WorkStealingDeque {
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque holds trivially copyable values");
+
+    struct Ring {
+        std::int64_t capacity;
+        std::int64_t mask;
+        std::atomic<T>* slots;
+
+        explicit Ring(std::int64_t size) : capacity(size), mask(size - 1), slots(new std::atomic<T>[size]) {}
+
+        ~Ring() {
+            delete[] slots;
+        }
+
+        T get(std::int64_t index) const {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t index, T value) {
+            slots[index & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<std::int64_t> _top;      // Owner end, one past the newest
+    alignas(64) std::atomic<std::int64_t> _bottom;   // Thief end, the oldest
+    std::atomic<Ring*> _ring;
+    std::vector<Ring*> _retired;                      // Outgrown rings (owner only)
+
+    // Atomics are neither copyable nor movable
+    WorkStealingDeque(const WorkStealingDeque& other);
+    WorkStealingDeque& operator=(const WorkStealingDeque& other);
+
+    Ring* grow(Ring* ring, std::int64_t bottom, std::int64_t top) {
+        Ring* bigger = new Ring(ring->capacity * 2);
+        for (std::int64_t i = bottom; i < top; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+        _retired.push_back(ring);
+        _ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+public:
+    // Constructor (capacity is rounded up to a power of two)
+    explicit WorkStealingDeque(std::size_t capacity = 256) : _top(0), _bottom(0) {
+        std::int64_t size = 2;
+        while (size < static_cast<std::int64_t>(capacity)) {
+            size *= 2;
+        }
+        _ring.store(new Ring(size), std::memory_order_relaxed);
+    }
+
+    // Destructor
+    ~WorkStealingDeque() {
+        delete _ring.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < _retired.size(); ++i) {
+            delete _retired[i];
+        }
+    }
+
+    // Owner only: add to the top
+    void push(T value) {
+        std::int64_t top = _top.load(std::memory_order_relaxed);
+        std::int64_t bottom = _bottom.load(std::memory_order_acquire);
+        Ring* ring = _ring.load(std::memory_order_relaxed);
+        if (top - bottom > ring->capacity - 1) {
+            ring = grow(ring, bottom, top);
+        }
+        ring->put(top, value);
+        _top.store(top + 1, std::memory_order_release);
+    }
+
+    /**
+     * Owner only: take the newest element
+     * @param out Receives the element
+     * @return false if the deque was empty (or a thief took the last one)
+     */
+    bool pop(T& out) {
+        std::int64_t top = _top.load(std::memory_order_relaxed) - 1;
+        Ring* ring = _ring.load(std::memory_order_relaxed);
+        // The store must not pass the load below, or the owner and a thief
+        // could both take the last element
+        _top.store(top, std::memory_order_seq_cst);
+        std::int64_t bottom = _bottom.load(std::memory_order_seq_cst);
+
+        if (bottom > top) {
+            // Empty
+            _top.store(top + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = ring->get(top);
+        if (bottom == top) {
+            // Last element: race the thieves for it
+            bool won = _bottom.compare_exchange_strong(bottom, bottom + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+            _top.store(top + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * Any thread: take the oldest element
+     * @param out Receives the element
+     * @return false if the deque was empty or another thread won the race
+     */
+    bool steal(T& out) {
+        std::int64_t bottom = _bottom.load(std::memory_order_seq_cst);
+        std::int64_t top = _top.load(std::memory_order_seq_cst);
+        if (bottom >= top) {
+            return false;
+        }
+        Ring* ring = _ring.load(std::memory_order_acquire);
+        T value = ring->get(bottom);
+        if (!_bottom.compare_exchange_strong(bottom, bottom + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    // Approximate element count (exact for the owner when nobody steals)
+    std::size_t size() const {
+        std::int64_t top = _top.load(std::memory_order_relaxed);
+        std::int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        return top > bottom ? static_cast<std::size_t>(top - bottom) : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
@@ -0,0 +1,390 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string>
+#include <mutex>
+#include <stack>
+#include <thread>
+#include <vector>
+#include "MutantStack.hpp"
+#include "StackArena.hpp"
+#include "ConcurrentMutantStack.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <random>
+
+#define CYAN "\033[36m"
+#define RESET "\033[0m"
+
+// Keeps the optimizer from discarding benchmarked results
+static volatile long g_sink;
+
+// Every global operator new in the process, to report allocations per request
+static size_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    ++g_allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+struct RequestResult {
+    double ns;
+    double allocations;
+};
+
+// One simulated request: build a stack of depth elements, walk it, drop it.
+// makeStack is called once per request; afterRequest runs between requests.
+template<typename MakeStack, typename AfterRequest>
+static RequestResult timeRequests(MakeStack makeStack, AfterRequest afterRequest, int depth, int requests) {
+    long total = 0;
+    size_t before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+        {
+            auto stack = makeStack();
+            for (int i = 0; i < depth; ++i) {
+                stack.push(i ^ r);
+            }
+            for (auto it = stack.begin(); it != stack.end(); ++it) {
+                total += *it;
+            }
+            while (stack.size() > static_cast<size_t>(depth / 2)) {
+                stack.pop();
+            }
+            total += stack.size();
+        }
+        afterRequest();
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = total;
+    RequestResult result;
+    result.ns = std::chrono::duration<double, std::nano>(end - start).count() / requests;
+    result.allocations = static_cast<double>(g_allocations - before) / requests;
+    return result;
+}
+
+static void printRow(const std::string& name, int depth, RequestResult result, double baseline) {
+    std::cout << std::setw(26) << name << std::setw(8) << depth << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.ns << std::setw(14) << result.allocations
+              << std::setw(12) << baseline / result.ns << "x" << std::endl;
+}
+
+static void benchRequests(int depth) {
+    int requests = depth <= 64 ? 2000000 : 20000000 / depth;
+    StackArena arena;
+
+    RequestResult deque = timeRequests([] { return MutantStack<int, std::deque<int> >(); },
+                                       [] {}, depth, requests);
+    RequestResult small = timeRequests([] { return MutantStack<int>(); },
+                                       [] {}, depth, requests);
+    RequestResult arenaStack = timeRequests([&arena] { return ArenaMutantStack<int>(arena.allocator()); },
+                                            [&arena] { arena.reset(); }, depth, requests);
+
+    printRow("std::deque", depth, deque, deque.ns);
+    printRow("SmallVector (default)", depth, small, deque.ns);
+    printRow("SmallVector + StackArena", depth, arenaStack, deque.ns);
+}
+
+// Mutex around a std::stack, the way shared stacks were guarded before
+class LockedStack {
+private:
+    std::mutex _mutex;
+    std::stack<int> _stack;
+
+public:
+    void push(int value) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stack.push(value);
+    }
+
+    bool tryPop(int& out) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stack.empty()) {
+            return false;
+        }
+        out = _stack.top();
+        _stack.pop();
+        return true;
+    }
+};
+
+// Nanoseconds per operation with `threads` threads sharing one stack, each
+// doing pushes and pops in equal number (two pushes, then two pops)
+template<typename Stack>
+static double timeContention(unsigned int threads, int total_ops) {
+    Stack stack;
+    int per_thread = total_ops / static_cast<int>(threads) / 4;
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&stack, per_thread, t] {
+            long total = 0;
+            int popped = 0;
+            for (int i = 0; i < per_thread; ++i) {
+                stack.push(i);
+                stack.push(static_cast<int>(t));
+                total += stack.tryPop(popped) ? popped : 0;
+                total += stack.tryPop(popped) ? popped : 0;
+            }
+            g_sink = total;
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count()
+           / (static_cast<double>(per_thread) * 4 * threads);
+}
+
+static void benchContention(unsigned int threads) {
+    const int total_ops = 4000000;
+    double locked = timeContention<LockedStack>(threads, total_ops);
+    double lockFree = timeContention<ConcurrentMutantStack<int> >(threads, total_ops);
+    std::cout << std::setw(10) << threads << std::fixed << std::setprecision(1)
+              << std::setw(16) << locked << std::setw(16) << lockFree
+              << std::setw(12) << locked / lockFree << "x" << std::endl;
+}
+
+__attribute__((noinline)) static long serialFib(int n) {
+    return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+}
+
+// Fork at every level above `cutoff`
+static long forkJoinFib(TaskScheduler& scheduler, int n, int cutoff) {
+    if (n <= cutoff) {
+        return serialFib(n);
+    }
+    long left = 0;
+    TaskGroup group(scheduler);
+    group.run([&scheduler, &left, n, cutoff] { left = forkJoinFib(scheduler, n - 1, cutoff); });
+    long right = forkJoinFib(scheduler, n - 2, cutoff);
+    group.wait();
+    return left + right;
+}
+
+// Quicksort that forks the left half and sorts small ranges with std::sort
+static void forkJoinSort(TaskScheduler& scheduler, int* first, int* last) {
+    if (last - first <= 4096) {
+        std::sort(first, last);
+        return;
+    }
+    int pivot = first[(last - first) / 2];
+    int* middle1 = std::partition(first, last, [pivot](int value) { return value < pivot; });
+    int* middle2 = std::partition(middle1, last, [pivot](int value) { return !(pivot < value); });
+    TaskGroup group(scheduler);
+    group.run([&scheduler, first, middle1] { forkJoinSort(scheduler, first, middle1); });
+    forkJoinSort(scheduler, middle2, last);
+    group.wait();
+}
+
+// Best of three runs, in milliseconds
+template<typename Function>
+static double timeMs(Function fn) {
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+static void benchForkJoin(unsigned int threads, double serialFibMs, double serialSortMs,
+                          const std::vector<int>& unsorted) {
+    TaskScheduler scheduler(threads);
+    // Fine-grained (cutoff 10: ~18k tasks) shows per-task overhead
+    double fine = timeMs([&scheduler] { g_sink = forkJoinFib(scheduler, 32, 10); });
+    double coarse = timeMs([&scheduler] { g_sink = forkJoinFib(scheduler, 32, 20); });
+    std::vector<int> values;
+    double sorted = timeMs([&scheduler, &values, &unsorted] {
+        values = unsorted;
+        forkJoinSort(scheduler, values.data(), values.data() + values.size());
+    });
+    g_sink = std::is_sorted(values.begin(), values.end());
+    std::cout << std::setw(10) << threads << std::fixed << std::setprecision(1)
+              << std::setw(14) << fine << std::setw(14) << coarse << std::setw(14) << sorted
+              << std::setw(11) << serialFibMs / coarse << "x" << std::setw(11) << serialSortMs / sorted << "x"
+              << std::endl;
+}
+
+// Milliseconds to unwind a copy of `loaded` in frames, best of three
+// (the copy itself is not timed)
+template<typename Stack, typename Unwind>
+static double timeUnwind(const Stack& loaded, Unwind unwind) {
+    double best = 0;
+    for (int run = 0; run < 3; ++run) {
+        Stack stack(loaded);
+        auto start = std::chrono::steady_clock::now();
+        unwind(stack);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (run == 0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+// Load 10^6 elements one push at a time and with push_range, then unwind
+// them in frames of `frame` with single pops and with pop_n
+template<typename Container>
+static void benchBulk(const std::string& name, const std::vector<int>& values, int frame) {
+    double single_push = timeMs([&values] {
+        MutantStack<int, Container> stack;
+        for (size_t i = 0; i < values.size(); ++i) {
+            stack.push(values[i]);
+        }
+        g_sink = stack.top() + stack.size();
+    });
+    double range_push = timeMs([&values] {
+        MutantStack<int, Container> stack;
+        stack.push_range(values.begin(), values.end());
+        g_sink = stack.top() + stack.size();
+    });
+    MutantStack<int, Container> loaded(values.begin(), values.end());
+    double single_pop = timeUnwind(loaded, [frame](MutantStack<int, Container>& stack) {
+        while (stack.size() >= static_cast<size_t>(frame)) {
+            for (int i = 0; i < frame; ++i) {
+                stack.pop();
+            }
+        }
+        g_sink = stack.size();
+    });
+    double bulk_pop = timeUnwind(loaded, [frame](MutantStack<int, Container>& stack) {
+        while (stack.size() >= static_cast<size_t>(frame)) {
+            stack.pop_n(frame);
+        }
+        g_sink = stack.size();
+    });
+    std::cout << std::setw(14) << name << std::fixed << std::setprecision(2)
+              << std::setw(12) << single_push << std::setw(12) << range_push
+              << std::setw(12) << single_pop << std::setw(12) << bulk_pop << std::endl;
+}
+
+// Sum and search the values with iterators and segment by segment
+template<typename Container>
+static void benchScan(const std::string& name, const std::vector<int>& values, int passes) {
+    MutantStack<int, Container> stack(values.begin(), values.end());
+    const int missing = -1;
+    double iterated_sum = timeMs([&stack, passes] {
+        for (int pass = 0; pass < passes; ++pass) {
+            long sum = 0;
+            for (typename MutantStack<int, Container>::iterator it = stack.begin(); it != stack.end(); ++it) {
+                sum += *it;
+            }
+            g_sink = sum;
+        }
+    }) / passes;
+    double segmented_sum = timeMs([&stack, passes] {
+        for (int pass = 0; pass < passes; ++pass) {
+            g_sink = segmented_accumulate(stack, 0L);
+        }
+    }) / passes;
+    double iterated_find = timeMs([&stack, missing, passes] {
+        for (int pass = 0; pass < passes; ++pass) {
+            g_sink = std::find(stack.begin(), stack.end(), missing) == stack.end();
+        }
+    }) / passes;
+    double segmented_find_ms = timeMs([&stack, missing, passes] {
+        for (int pass = 0; pass < passes; ++pass) {
+            g_sink = segmented_find(stack, missing, std::nothrow) == stack.end();
+        }
+    }) / passes;
+    std::cout << std::setw(14) << name << std::fixed << std::setprecision(2)
+              << std::setw(12) << iterated_sum << std::setw(12) << segmented_sum
+              << std::setw(12) << iterated_find << std::setw(12) << segmented_find_ms << std::endl;
+}
+
+int main() {
+    std::cout << "=== MUTANTSTACK BENCHMARKS ===" << std::endl;
+
+    std::cout << "\n--- Short-lived stacks, one per request (ns and allocations per request) ---" << std::endl;
+    std::cout << CYAN << std::setw(26) << "Container" << std::setw(8) << "Depth"
+              << std::setw(14) << "ns" << std::setw(14) << "allocations"
+              << std::setw(13) << "Speedup" << RESET << std::endl;
+    const int depths[] = {8, 64, 1024, 100000};
+    for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); ++d) {
+        benchRequests(depths[d]);
+    }
+
+    std::cout << "\n--- Shared stack under contention (ns per push or pop, "
+              << std::thread::hardware_concurrency() << " cores) ---" << std::endl;
+    std::cout << CYAN << std::setw(10) << "Threads" << std::setw(16) << "mutex+stack"
+              << std::setw(16) << "lock-free" << std::setw(13) << "Speedup" << RESET << std::endl;
+    for (unsigned int threads = 1; threads <= 64; threads *= 2) {
+        benchContention(threads);
+    }
+
+    std::vector<int> million(1000000);
+    for (size_t i = 0; i < million.size(); ++i) {
+        million[i] = static_cast<int>(i);
+    }
+    std::cout << "\n--- Bulk push/pop of 10^6 ints, pops in frames of 200 (ms) ---" << std::endl;
+    std::cout << CYAN << std::setw(14) << "Container" << std::setw(12) << "push x1"
+              << std::setw(12) << "push_range" << std::setw(12) << "pop x1" << std::setw(12) << "pop_n"
+              << RESET << std::endl;
+    benchBulk<std::deque<int> >("std::deque", million, 200);
+    benchBulk<SmallVector<int> >("SmallVector", million, 200);
+
+    std::cout << "\n--- Scans over 10^6 ints: iterators vs segments (ms per pass; find misses) ---" << std::endl;
+    std::cout << CYAN << std::setw(14) << "Container" << std::setw(12) << "it sum"
+              << std::setw(12) << "seg sum" << std::setw(12) << "it find" << std::setw(12) << "seg find"
+              << RESET << std::endl;
+    benchScan<std::deque<int> >("std::deque", million, 20);
+    benchScan<SmallVector<int> >("SmallVector", million, 20);
+
+    // Past the caches, where the per-segment overhead has to stay below
+    // the memory traffic
+    std::vector<int> large(20000000);
+    for (size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<int>(i);
+    }
+    std::cout << "\n--- Scans over 2*10^7 ints: iterators vs segments (ms per pass; find misses) ---" << std::endl;
+    std::cout << CYAN << std::setw(14) << "Container" << std::setw(12) << "it sum"
+              << std::setw(12) << "seg sum" << std::setw(12) << "it find" << std::setw(12) << "seg find"
+              << RESET << std::endl;
+    benchScan<std::deque<int> >("std::deque", large, 3);
+    benchScan<SmallVector<int> >("SmallVector", large, 3);
+
+    std::mt19937 gen(42);
+    std::vector<int> unsorted(4000000);
+    for (size_t i = 0; i < unsorted.size(); ++i) {
+        unsorted[i] = static_cast<int>(gen());
+    }
+    double serialFibMs = timeMs([] { g_sink = serialFib(32); });
+    std::vector<int> serialSorted;
+    double serialSortMs = timeMs([&serialSorted, &unsorted] {
+        serialSorted = unsorted;
+        std::sort(serialSorted.begin(), serialSorted.end());
+    });
+
+    std::cout << "\n--- Fork-join on TaskScheduler (ms; serial fib(32) " << std::fixed << std::setprecision(1)
+              << serialFibMs << ", std::sort of 4M ints " << serialSortMs << ") ---" << std::endl;
+    std::cout << CYAN << std::setw(10) << "Workers" << std::setw(14) << "fib cut 10"
+              << std::setw(14) << "fib cut 20" << std::setw(14) << "sort 4M"
+              << std::setw(12) << "fib gain" << std::setw(12) << "sort gain" << RESET << std::endl;
+    unsigned int cores = std::thread::hardware_concurrency();
+    for (unsigned int threads = 1; threads <= (cores < 4 ? 4 : cores); threads *= 2) {
+        benchForkJoin(threads, serialFibMs, serialSortMs, unsorted);
+    }
+    return 0;
+}
@@ -4,7 +4,21 @@
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <deque>
+#include <string>
+#include <utility>
+#include <memory_resource>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <cstdint>
 #include "MutantStack.hpp"
+#include "StackArena.hpp"
+#include "ConcurrentMutantStack.hpp"
+#include "WorkStealingDeque.hpp"
+#include "TaskScheduler.hpp"
+#include "instrument.hpp"
+#include <stdexcept>
 
 // Test colors for output
 #define GREEN "\033[32m"
@@ -239,9 +253,9 @@ void testDifferentContainers() {
     }
     std::cout << std::endl;
     
-    // Test with std::deque (default)
-    std::cout << YELLOW << "Using std::deque as underlying container (default):" << RESET << std::endl;
-    MutantStack<int> deque_stack;
+    // Test with std::deque
+    std::cout << YELLOW << "Using std::deque as underlying container:" << RESET << std::endl;
+    MutantStack<int, std::deque<int>> deque_stack;
     deque_stack.push(100);
     deque_stack.push(200);
     deque_stack.push(300);
@@ -252,9 +266,644 @@ void testDifferentContainers() {
     }
     std::cout << std::endl;
     
+    // Test with std::list
+    std::cout << YELLOW << "Using std::list as underlying container:" << RESET << std::endl;
+    MutantStack<int, std::list<int>> list_stack;
+    list_stack.push(1000);
+    list_stack.push(2000);
+    
+    std::cout << "List-based stack: ";
+    for (auto it = list_stack.begin(); it != list_stack.end(); ++it) {
+        std::cout << *it << " ";
+    }
+    std::cout << std::endl;
+    
+    // Conversions to std::stack over another container
+    std::stack<int> from_vector(vector_stack);
+    std::stack<int, std::vector<int>> from_deque(deque_stack);
+    std::cout << (from_vector.top() == 30 && from_deque.top() == 300 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Converted to std::stack over another container" << std::endl;
+    
     std::cout << GREEN << "✓ Different container types test passed!" << RESET << std::endl;
 }
 
+// Test the default SmallVector storage
+void testSmallVectorStorage() {
+    std::cout << BLUE << "\n=== SMALLVECTOR STORAGE TEST ===" << RESET << std::endl;
+    
+    // Shallow stacks stay in the inline buffer
+    MutantStack<int> mstack;
+    for (int i = 0; i < 16; ++i) {
+        mstack.push(i);
+    }
+    bool contiguous = true;
+    int* first = &*mstack.begin();
+    for (int i = 0; i < 16; ++i) {
+        contiguous = contiguous && first + i == &mstack.begin()[i];
+    }
+    std::cout << (contiguous ? GREEN "✓ " : RED "✗ ") << RESET
+              << "16 ints stored contiguously, pointer iterators" << std::endl;
+    
+    // Growth past the inline capacity keeps the contents and order
+    for (int i = 16; i < 1000; ++i) {
+        mstack.push(i);
+    }
+    bool ordered = mstack.size() == 1000;
+    int expected = 0;
+    for (MutantStack<int>::iterator it = mstack.begin(); it != mstack.end(); ++it) {
+        ordered = ordered && *it == expected++;
+    }
+    std::cout << (ordered ? GREEN "✓ " : RED "✗ ") << RESET << "Grew to 1000 elements in order" << std::endl;
+    
+    // Reverse iteration over pointer iterators
+    bool reversed = *mstack.rbegin() == 999 && *(mstack.rend() - 1) == 0;
+    std::cout << (reversed ? GREEN "✓ " : RED "✗ ") << RESET << "Reverse iterators see top first" << std::endl;
+    
+    // Non-trivial elements survive growth; pushing a copy of the top while
+    // the buffer grows must not read a moved-from element
+    MutantStack<std::string> strings;
+    strings.push("a fairly long string that does not fit in the small-string buffer");
+    for (int i = 0; i < 100; ++i) {
+        strings.push(strings.top());
+    }
+    bool same = strings.size() == 101;
+    for (MutantStack<std::string>::iterator it = strings.begin(); it != strings.end(); ++it) {
+        same = same && *it == strings.top();
+    }
+    std::cout << (same ? GREEN "✓ " : RED "✗ ") << RESET << "101 std::string copies of the top survive growth" << std::endl;
+    
+    // Direct SmallVector checks
+    SmallVector<int, 4> small;
+    for (int i = 0; i < 4; ++i) {
+        small.push_back(i);
+    }
+    bool inline_before = small.is_inline();
+    small.push_back(4);
+    std::cout << (inline_before && !small.is_inline() && small.capacity() >= 5 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "SmallVector<int, 4> leaves the inline buffer on the 5th push" << std::endl;
+    
+    bool threw = false;
+    try {
+        small.at(5);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    std::cout << (threw ? GREEN "✓ " : RED "✗ ") << RESET << "at() past the end throws std::out_of_range" << std::endl;
+    
+    std::cout << GREEN << "✓ SmallVector storage test passed!" << RESET << std::endl;
+}
+
+// Test move construction and move assignment
+void testMoveSemantics() {
+    std::cout << BLUE << "\n=== MOVE SEMANTICS TEST ===" << RESET << std::endl;
+    
+    // A heap-backed stack hands its buffer over without copying
+    MutantStack<int> big;
+    for (int i = 0; i < 100; ++i) {
+        big.push(i);
+    }
+    int* buffer = &*big.begin();
+    MutantStack<int> moved(std::move(big));
+    std::cout << (&*moved.begin() == buffer && moved.size() == 100 && big.empty() ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Move constructor steals the heap buffer and empties the source" << std::endl;
+    
+    // An inline stack moves its elements
+    MutantStack<std::string> small;
+    small.push("one");
+    small.push("two");
+    MutantStack<std::string> target;
+    target.push("old");
+    target = std::move(small);
+    std::cout << (target.size() == 2 && target.top() == "two" && small.empty() ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Move assignment of an inline stack moves its elements" << std::endl;
+    
+    // The moved-from stack is still usable
+    small.push("again");
+    std::cout << (small.size() == 1 && small.top() == "again" ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Moved-from stack can be reused" << std::endl;
+    
+    // Other containers move too
+    MutantStack<int, std::deque<int>> deque_stack;
+    deque_stack.push(7);
+    MutantStack<int, std::deque<int>> deque_moved;
+    deque_moved = std::move(deque_stack);
+    std::cout << (deque_moved.top() == 7 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::deque-backed stack move-assigns" << std::endl;
+    
+    std::cout << GREEN << "✓ Move semantics test passed!" << RESET << std::endl;
+}
+
+// Test allocator pass-through and the arena
+void testArenaAllocator() {
+    std::cout << BLUE << "\n=== ARENA ALLOCATOR TEST ===" << RESET << std::endl;
+    
+    StackArena arena(1024);
+    
+    // First request sizes the arena
+    {
+        ArenaMutantStack<int> stack(arena.allocator());
+        for (int i = 0; i < 5000; ++i) {
+            stack.push(i);
+        }
+        long sum = 0;
+        for (ArenaMutantStack<int>::iterator it = stack.begin(); it != stack.end(); ++it) {
+            sum += *it;
+        }
+        std::cout << (sum == 5000L * 4999 / 2 ? GREEN "✓ " : RED "✗ ") << RESET
+                  << "Arena-backed stack holds 5000 elements" << std::endl;
+    }
+    arena.reset();
+    
+    // Later requests of the same shape reuse the chunks
+    size_t warmed = arena.systemAllocations();
+    for (int request = 0; request < 100; ++request) {
+        ArenaMutantStack<int> stack(arena.allocator());
+        for (int i = 0; i < 5000; ++i) {
+            stack.push(i);
+        }
+        ArenaMutantStack<int> moved(std::move(stack));
+        moved.pop();
+        arena.reset();
+    }
+    std::cout << (warmed > 0 && arena.systemAllocations() == warmed ? GREEN "✓ " : RED "✗ ") << RESET
+              << "100 requests after reset() allocate nothing from the system" << std::endl;
+    
+    // Copies with an allocator land in that allocator's arena
+    StackArena other;
+    ArenaMutantStack<int> source(arena.allocator());
+    for (int i = 0; i < 100; ++i) {
+        source.push(i);
+    }
+    ArenaMutantStack<int> copy(source, other.allocator());
+    std::cout << (copy.size() == 100 && copy.top() == 99 && other.systemAllocations() == 1 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Allocator-extended copy allocates from the given arena" << std::endl;
+    
+    // Pass-through works for standard allocator-aware containers too
+    std::pmr::monotonic_buffer_resource resource;
+    MutantStack<int, std::pmr::deque<int>> pmr_stack(&resource);
+    pmr_stack.push(1);
+    pmr_stack.push(2);
+    std::cout << (pmr_stack.top() == 2 && *pmr_stack.begin() == 1 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::pmr::deque receives a memory_resource through MutantStack" << std::endl;
+    
+    std::cout << GREEN << "✓ Arena allocator test passed!" << RESET << std::endl;
+}
+
+// Test the lock-free stack
+void testConcurrentStack() {
+    std::cout << BLUE << "\n=== CONCURRENT STACK TEST ===" << RESET << std::endl;
+    
+    // Single thread: LIFO order and snapshot iteration like MutantStack
+    ConcurrentMutantStack<int> stack;
+    for (int i = 1; i <= 5; ++i) {
+        stack.push(i * 10);
+    }
+    ConcurrentMutantStack<int>::Snapshot snapshot = stack.snapshot();
+    std::cout << "Snapshot (bottom to top): ";
+    for (ConcurrentMutantStack<int>::Snapshot::iterator it = snapshot.begin(); it != snapshot.end(); ++it) {
+        std::cout << *it << " ";
+    }
+    std::cout << std::endl;
+    int value = 0;
+    bool lifo = snapshot.top() == 50 && *snapshot.rbegin() == 50 && stack.tryPop(value) && value == 50;
+    std::cout << (lifo ? GREEN "✓ " : RED "✗ ") << RESET << "Pop returns the last push" << std::endl;
+    std::cout << (snapshot.size() == 5 && stack.size() == 4 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Snapshot is unaffected by later pops" << std::endl;
+    while (stack.tryPop(value)) {
+    }
+    std::cout << (stack.empty() && !stack.tryPop(value) ? GREEN "✓ " : RED "✗ ") << RESET
+              << "tryPop on an empty stack returns false" << std::endl;
+    
+    // Several threads push, then several pop: every value comes out once
+    const int threads = 4;
+    const int per_thread = 20000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&stack, t, per_thread] {
+            for (int i = 0; i < per_thread; ++i) {
+                stack.push(t * per_thread + i);
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    workers.clear();
+    std::vector<char> seen(threads * per_thread, 0);
+    std::atomic<int> duplicates(0);
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&stack, &seen, &duplicates] {
+            int popped;
+            while (stack.tryPop(popped)) {
+                if (seen[popped]++ != 0) {
+                    duplicates.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    workers.clear();
+    bool all_once = duplicates.load() == 0 && std::count(seen.begin(), seen.end(), 1) == threads * per_thread;
+    std::cout << (all_once ? GREEN "✓ " : RED "✗ ") << RESET << threads * per_thread
+              << " values pushed and popped by " << threads << " threads, each exactly once" << std::endl;
+    
+    // Snapshots taken while others push and pop are exact: each thread's
+    // values appear in the order that thread pushed them
+    const int rounds = 50000;
+    std::atomic<int> finished(0);
+    for (int t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&stack, &finished, t, rounds] {
+            int popped;
+            for (int i = 0; i < rounds; ++i) {
+                stack.push((t << 24) | i);
+                if (i % 3 == 0) {
+                    stack.tryPop(popped);
+                }
+            }
+            finished.fetch_add(1);
+        }));
+    }
+    bool consistent = true;
+    int snapshots = 0;
+    while (consistent && (snapshots < 20 || finished.load() < threads) && snapshots < 200) {
+        ConcurrentMutantStack<int>::Snapshot view = stack.snapshot();
+        int last[threads] = {-1, -1, -1, -1};
+        for (ConcurrentMutantStack<int>::Snapshot::iterator it = view.begin(); it != view.end(); ++it) {
+            int owner = *it >> 24;
+            int sequence = *it & 0xFFFFFF;
+            consistent = consistent && owner >= 0 && owner < threads && sequence > last[owner];
+            if (owner >= 0 && owner < threads) {
+                last[owner] = sequence;
+            }
+        }
+        ++snapshots;
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    std::cout << (consistent ? GREEN "✓ " : RED "✗ ") << RESET << snapshots
+              << " snapshots under concurrent push/pop are consistent" << std::endl;
+    
+    std::cout << GREEN << "✓ Concurrent stack test passed!" << RESET << std::endl;
+}
+
+// Fork-join fib for the scheduler test
+static long parallelFib(TaskScheduler& scheduler, int n) {
+    if (n < 2) {
+        return n;
+    }
+    if (n < 10) {
+        return parallelFib(scheduler, n - 1) + parallelFib(scheduler, n - 2);
+    }
+    long left = 0;
+    TaskGroup group(scheduler);
+    group.run([&scheduler, &left, n] { left = parallelFib(scheduler, n - 1); });
+    long right = parallelFib(scheduler, n - 2);
+    group.wait();
+    return left + right;
+}
+
+// Test the work-stealing deque and the scheduler on top of it
+void testWorkStealing() {
+    std::cout << BLUE << "\n=== WORK-STEALING TEST ===" << RESET << std::endl;
+    
+    // Owner pops LIFO from the top, thieves steal FIFO from the bottom
+    WorkStealingDeque<int> deque(2);
+    for (int i = 1; i <= 5; ++i) {
+        deque.push(i);
+    }
+    int stolen = 0;
+    int popped = 0;
+    bool ends = deque.steal(stolen) && stolen == 1 && deque.pop(popped) && popped == 5 && deque.size() == 3;
+    std::cout << (ends ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Owner pops the newest (5), a thief steals the oldest (1)" << std::endl;
+    while (deque.pop(popped)) {
+    }
+    std::cout << (!deque.pop(popped) && !deque.steal(stolen) ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Empty deque refuses pop and steal" << std::endl;
+    
+    // One owner pushing and popping against three thieves: every value is
+    // taken exactly once
+    const int values = 100000;
+    std::vector<char> taken(values, 0);
+    std::atomic<int> duplicates(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.push_back(std::thread([&deque, &taken, &duplicates, &done] {
+            int value;
+            while (!done.load() || !deque.empty()) {
+                if (deque.steal(value) && taken[value]++ != 0) {
+                    duplicates.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (int i = 0; i < values; ++i) {
+        deque.push(i);
+        if (i % 4 == 3 && deque.pop(popped) && taken[popped]++ != 0) {
+            duplicates.fetch_add(1);
+        }
+    }
+    while (deque.pop(popped)) {
+        if (taken[popped]++ != 0) {
+            duplicates.fetch_add(1);
+        }
+    }
+    done.store(true);
+    for (size_t t = 0; t < thieves.size(); ++t) {
+        thieves[t].join();
+    }
+    bool once = duplicates.load() == 0 && std::count(taken.begin(), taken.end(), 1) == values;
+    std::cout << (once ? GREEN "✓ " : RED "✗ ") << RESET << values
+              << " values shared by an owner and 3 thieves, each taken once" << std::endl;
+    
+    // Fork-join on the scheduler
+    TaskScheduler scheduler(4);
+    long fib = parallelFib(scheduler, 25);
+    std::cout << (fib == 75025 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Parallel fib(25) on " << scheduler.threads() << " workers = " << fib << std::endl;
+    
+    // Many independent tasks from outside the pool
+    std::atomic<long> sum(0);
+    {
+        TaskGroup group(scheduler);
+        for (int i = 1; i <= 1000; ++i) {
+            group.run([&sum, i] { sum.fetch_add(i); });
+        }
+        group.wait();
+    }
+    std::cout << (sum.load() == 500500 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "1000 tasks submitted from outside the pool all ran" << std::endl;
+    
+    // Exceptions reach wait()
+    bool rethrown = false;
+    TaskGroup failing(scheduler);
+    failing.run([] { throw std::runtime_error("task failed"); });
+    try {
+        failing.wait();
+    } catch (const std::runtime_error&) {
+        rethrown = true;
+    }
+    std::cout << (rethrown ? GREEN "✓ " : RED "✗ ") << RESET << "A task's exception is rethrown by wait()" << std::endl;
+    
+    std::cout << GREEN << "✓ Work-stealing test passed!" << RESET << std::endl;
+}
+
+// Test bulk push/pop and range construction
+void testBulkOperations() {
+    std::cout << BLUE << "\n=== BULK OPERATIONS TEST ===" << RESET << std::endl;
+    
+    // push_range from contiguous and node-based sources
+    std::vector<int> source;
+    for (int i = 0; i < 1000; ++i) {
+        source.push_back(i);
+    }
+    std::list<int> tail;
+    tail.push_back(1000);
+    tail.push_back(1001);
+    MutantStack<int> mstack;
+    mstack.push(-1);
+    mstack.push_range(source.begin(), source.end());
+    mstack.push_range(tail);
+    bool in_order = mstack.size() == 1003 && *mstack.begin() == -1 && mstack.top() == 1001;
+    for (int i = 0; i < 1000 && in_order; ++i) {
+        in_order = mstack.begin()[i + 1] == i;
+    }
+    std::cout << (in_order ? GREEN "✓ " : RED "✗ ") << RESET
+              << "push_range appends 1000 + 2 elements above the existing one, in order" << std::endl;
+    
+    // pop_n discarding, then pop_n into a buffer
+    mstack.pop_n(2);
+    std::vector<int> frames;
+    mstack.pop_n(200, std::back_inserter(frames));
+    bool popped = mstack.size() == 801 && mstack.top() == 799 && frames.size() == 200
+                  && frames.front() == 800 && frames.back() == 999;
+    std::cout << (popped ? GREEN "✓ " : RED "✗ ") << RESET
+              << "pop_n(2) discards, pop_n(200, out) moves out 800..999 deepest first" << std::endl;
+    
+    bool threw = false;
+    try {
+        mstack.pop_n(mstack.size() + 1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    std::cout << (threw && mstack.size() == 801 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "pop_n past the bottom throws and leaves the stack intact" << std::endl;
+    
+    // Range constructor and other containers
+    MutantStack<int> built(source.begin(), source.begin() + 10);
+    MutantStack<int, std::deque<int>> deque_stack(source.begin(), source.end());
+    deque_stack.pop_n(990);
+    deque_stack.push_range(tail);
+    std::cout << (built.size() == 10 && built.top() == 9 && deque_stack.size() == 12 && deque_stack.top() == 1001
+                  ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Range constructor and bulk operations on std::deque" << std::endl;
+    
+    // Non-trivial elements, with and without growth
+    MutantStack<std::string> strings;
+    strings.reserve(4);
+    strings.emplace(3, 'a');
+    std::vector<std::string> words(40, "a word long enough to live on the heap");
+    strings.push_range(words);
+    std::vector<std::string> out;
+    strings.pop_n(39, std::back_inserter(out));
+    bool strings_ok = strings.size() == 2 && strings.top() == words[0] && *strings.begin() == "aaa"
+                      && out.size() == 39 && out.back() == words[0];
+    std::cout << (strings_ok ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::string elements survive bulk push and pop" << std::endl;
+    
+    // SmallVector insert/erase in the middle (used by the bulk operations)
+    SmallVector<int, 4> ints(source.begin(), source.begin() + 6);
+    int extra[] = {100, 101, 102};
+    ints.insert(ints.begin() + 2, extra, extra + 3);
+    ints.erase(ints.begin(), ints.begin() + 1);
+    int expected_ints[] = {1, 100, 101, 102, 2, 3, 4, 5};
+    SmallVector<std::string, 2> texts(words.begin(), words.begin() + 3);
+    texts.insert(texts.begin() + 1, "middle");
+    texts.erase(texts.begin());
+    bool middle = ints.size() == 8 && std::equal(ints.begin(), ints.end(), expected_ints)
+                  && texts.size() == 3 && texts[0] == "middle" && texts[1] == words[1];
+    std::cout << (middle ? GREEN "✓ " : RED "✗ ") << RESET
+              << "SmallVector inserts and erases in the middle" << std::endl;
+    
+    std::cout << GREEN << "✓ Bulk operations test passed!" << RESET << std::endl;
+}
+
+// Test segmented iteration over contiguous and chunked storage
+void testSegmentedIteration() {
+    std::cout << BLUE << "\n=== SEGMENTED ITERATION TEST ===" << RESET << std::endl;
+    
+    MutantStack<int, std::deque<int>> deque_stack;
+    MutantStack<int> vector_stack;
+    for (int i = 0; i < 10000; ++i) {
+        deque_stack.push(i);
+        vector_stack.push(i);
+    }
+    
+    // Segments cover the stack bottom to top, with no gaps
+    size_t deque_segments = 0;
+    size_t covered = 0;
+    bool in_order = true;
+    deque_stack.for_each_segment([&](const int* data, std::size_t length) {
+        ++deque_segments;
+        for (std::size_t i = 0; i < length; ++i) {
+            in_order = in_order && data[i] == static_cast<int>(covered + i);
+        }
+        covered += length;
+    });
+    std::cout << (deque_segments > 1 && covered == 10000 && in_order ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::deque is visited as " << deque_segments << " chunks, in stack order" << std::endl;
+    
+    // Subranges starting and ending mid-chunk: every run is contiguous and
+    // the runs add up to the range, in order
+    std::deque<int> plain(10000);
+    for (int i = 0; i < 10000; ++i) {
+        plain[i] = i;
+    }
+    bool runs_ok = true;
+    const int offsets[] = {0, 1, 5, 127, 128, 300};
+    for (size_t o = 0; o < sizeof(offsets) / sizeof(offsets[0]); ++o) {
+        int next = offsets[o];
+        forEachSegment(plain.begin() + offsets[o], plain.end() - offsets[o], [&](const int* data, std::size_t length) {
+            for (std::size_t i = 0; i < length; ++i) {
+                runs_ok = runs_ok && data[i] == next++;
+            }
+        });
+        runs_ok = runs_ok && next == 10000 - offsets[o];
+    }
+    std::cout << (runs_ok ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::deque subranges split into contiguous runs" << std::endl;
+    
+    size_t vector_segments = 0;
+    const MutantStack<int>& const_vector_stack = vector_stack;
+    const_vector_stack.for_each_segment([&](const int* data, std::size_t length) {
+        ++vector_segments;
+        in_order = data == &*vector_stack.begin() && length == 10000;
+    });
+    std::cout << (vector_segments == 1 && in_order ? GREEN "✓ " : RED "✗ ") << RESET
+              << "SmallVector storage is a single segment" << std::endl;
+    
+    // Node-based containers fall back to runs of adjacent elements
+    MutantStack<int, std::list<int>> list_stack;
+    for (int i = 0; i < 100; ++i) {
+        list_stack.push(i);
+    }
+    long list_sum = segmented_accumulate(list_stack, 0L);
+    std::cout << (list_sum == 4950 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "std::list fallback: segmented_accumulate = " << list_sum << std::endl;
+    
+    // Stopping early and empty stacks
+    size_t visited = 0;
+    bool completed = deque_stack.for_each_segment([&visited](const int*, std::size_t) {
+        ++visited;
+        return false;
+    });
+    MutantStack<int, std::deque<int>> empty_stack;
+    size_t empty_segments = 0;
+    empty_stack.for_each_segment([&empty_segments](const int*, std::size_t) {
+        ++empty_segments;
+    });
+    std::cout << (!completed && visited == 1 && empty_segments == 0 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "A visitor returning false stops the walk; an empty stack has no segments" << std::endl;
+    
+    // Segmented algorithms agree with the iterator versions
+    long deque_sum = segmented_accumulate(deque_stack, 0L);
+    long iterated_sum = std::accumulate(deque_stack.begin(), deque_stack.end(), 0L);
+    std::cout << (deque_sum == iterated_sum && deque_sum == 10000L * 9999 / 2 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "segmented_accumulate matches std::accumulate: " << deque_sum << std::endl;
+    
+    segmented_for_each(deque_stack, [](int& value) { value *= 2; });
+    bool doubled = deque_stack.top() == 19998 && deque_stack.begin()[5000] == 10000;
+    int counted = segmented_for_each(deque_stack, [count = 0](int) mutable { return ++count; })(0);
+    std::cout << (doubled && counted == 10001 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "segmented_for_each writes through and returns the function" << std::endl;
+    
+    MutantStack<int, std::deque<int>>::iterator hit = segmented_find(deque_stack, 15000);
+    bool found = hit - deque_stack.begin() == 7500 && *hit == 15000
+                 && segmented_find(deque_stack, 15001, std::nothrow) == deque_stack.end()
+                 && *segmented_find(const_vector_stack, 9999) == 9999;
+    bool threw = false;
+    try {
+        segmented_find(deque_stack, -2);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    std::cout << (found && threw ? GREEN "✓ " : RED "✗ ") << RESET
+              << "segmented_find returns the first match across chunks, throws on a miss" << std::endl;
+    
+    std::cout << GREEN << "✓ Segmented iteration test passed!" << RESET << std::endl;
+}
+
+// Test the instrumentation layer shared by the three exercises
+void testInstrumentation() {
+    std::cout << BLUE << "\n=== INSTRUMENTATION TEST ===" << RESET << std::endl;
+    
+    // HDR-style buckets: exact below 8, then 8 buckets per power of two
+    bool buckets_ok = instrument::bucketOf(7) == 7 && instrument::bucketOf(8) == 8
+                      && instrument::bucketOf(15) == 15 && instrument::bucketOf(16) == 16
+                      && instrument::bucketFloor(instrument::bucketOf(1000)) == 960
+                      && instrument::bucketOf(~0ULL) == instrument::BUCKETS - 1;
+    for (std::uint64_t value = 1; value < (1ULL << 40) && buckets_ok; value = value * 3 + 1) {
+        std::uint64_t floor = instrument::bucketFloor(instrument::bucketOf(value));
+        buckets_ok = floor <= value && value - floor <= floor / 8;
+    }
+    std::cout << (buckets_ok ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Histogram buckets are within 12.5% of every value" << std::endl;
+    
+    // Values recorded by exited threads are kept; percentiles come from buckets
+    instrument::Snapshot before = instrument::snapshot();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([] {
+            for (std::uint64_t value = 1; value <= 1000; ++value) {
+                instrument::record(instrument::SPAN_LONGEST_SPAN, value);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    instrument::Snapshot after = instrument::snapshot();
+    const instrument::ProbeStats& longest = after[instrument::SPAN_LONGEST_SPAN];
+    std::uint64_t recorded = longest.count - before[instrument::SPAN_LONGEST_SPAN].count;
+    std::uint64_t summed = longest.sum - before[instrument::SPAN_LONGEST_SPAN].sum;
+    bool merged = recorded == 4000 && summed == 4 * 500500;
+    std::uint64_t p50 = longest.percentile(0.5);
+    std::cout << (merged && longest.max >= 1000 && p50 >= 440 && p50 <= 560 ? GREEN "✓ " : RED "✗ ") << RESET
+              << "4 threads x 1000 values merged after exit (p50 ~ " << p50 << ")" << std::endl;
+    
+    // Text formats
+    std::string json = instrument::toJson(after);
+    std::string prometheus = instrument::toPrometheus(after);
+    bool formats_ok = json.find("\"span_longest_span\": {\"unit\": \"ns\", \"count\": ") != std::string::npos
+                      && prometheus.find("# TYPE cpp08_stack_push_nanoseconds histogram") != std::string::npos
+                      && prometheus.find("cpp08_easyfind_scan_elements_count") != std::string::npos;
+    std::cout << (formats_ok ? GREEN "✓ " : RED "✗ ") << RESET
+              << "Statistics render as JSON and Prometheus text" << std::endl;
+    
+    // Hooks in MutantStack record only in instrumented builds
+    MutantStack<int> mstack;
+    for (int i = 0; i < 100; ++i) {
+        mstack.push(i);
+    }
+    mstack.pop();
+    instrument::Snapshot hooked = instrument::snapshot();
+    std::uint64_t pushes = hooked[instrument::STACK_PUSH].count - after[instrument::STACK_PUSH].count;
+    std::uint64_t pops = hooked[instrument::STACK_POP].count - after[instrument::STACK_POP].count;
+#ifdef CPP08_INSTRUMENT
+    bool hooks_ok = pushes == 100 && pops == 1;
+#else
+    bool hooks_ok = pushes == 0 && pops == 0;
+#endif
+    std::cout << (hooks_ok ? GREEN "✓ " : RED "✗ ") << RESET
+              << "MutantStack hooks recorded " << pushes << " pushes and " << pops << " pop" << std::endl;
+    
+    std::cout << GREEN << "✓ Instrumentation test passed!" << RESET << std::endl;
+}
+
 // Test STL algorithms compatibility
 void testSTLAlgorithms() {
     std::cout << BLUE << "\n=== STL ALGORITHMS COMPATIBILITY TEST ===" << RESET << std::endl;
@@ -302,11 +951,26 @@ int main() {
     testStackOperations();
     testCopyAndAssignment();
     testDifferentContainers();
+    testSmallVectorStorage();
+    testMoveSemantics();
+    testArenaAllocator();
+    testConcurrentStack();
+    testWorkStealing();
+    testBulkOperations();
+    testSegmentedIteration();
+    testInstrumentation();
     testSTLAlgorithms();
     
     std::cout << CYAN << "\n================================================" << RESET << std::endl;
     std::cout << CYAN << "           ALL TESTS COMPLETED                 " << RESET << std::endl;
     std::cout << CYAN << "================================================" << RESET << std::endl;
     
+#ifdef CPP08_INSTRUMENT
+    // Built with make INSTRUMENT=1: write out what the hooks recorded
+    instrument::dump("mutantstack_stats.json");
+    instrument::dump("mutantstack_stats.prom", instrument::PROMETHEUS);
+    std::cout << "Instrumentation written to mutantstack_stats.json and mutantstack_stats.prom" << std::endl;
+#endif
+    
     return 0;
 }